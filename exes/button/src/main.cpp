@@ -8,6 +8,7 @@
 #include <tfc/ipc.hpp>
 #include <tfc/logger.hpp>
 #include <tfc/progbase.hpp>
+#include <tfc/utils/timing_wheel.hpp>
 
 namespace asio = boost::asio;
 
@@ -56,14 +57,9 @@ constexpr auto too_long_press = [](my_deps& deps) {
 
 // actions
 constexpr auto start_timeout = [](const auto&, auto& state_machine, auto& deps, const auto& subs) {
-  // Create a timer from a shared_ptr
   auto deps_v = deps.value;
-  auto timer = std::make_shared<asio::steady_timer>(deps_v.ctx);
-  auto left = 500ms;
-  timer->expires_after(left);
-  // Copy the timer into the callback to make another shared_ptr
-  // reference
-  timer->async_wait([&, timer_copy = timer](const std::error_code& err) {
+  // The timer lives in the timing wheel of the io_context, no timer object to keep alive
+  tfc::utils::timing_wheel::of(deps_v.ctx).schedule_after(500ms, [&](const std::error_code& err) {
     if (err) {
       return;
     }
@@ -79,13 +75,7 @@ constexpr auto send_signal = [](asio::io_context& ctx, tfc::ipc::bool_signal& si
     }
   });
 
-  // Create a timer from a shared_ptr
-  auto timer = std::make_shared<asio::steady_timer>(ctx);
-  timer->expires_after(100ms);
-
-  // Copy the timer into the callback to make another shared_ptr
-  // reference
-  timer->async_wait([&, timer_copy = timer](const std::error_code& timer_err) {
+  tfc::utils::timing_wheel::of(ctx).schedule_after(100ms, [&](const std::error_code& timer_err) {
     if (timer_err) {
       return;
     }
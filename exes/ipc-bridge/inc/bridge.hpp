@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <azmq/socket.hpp>
+#include <boost/asio.hpp>
+
+#include <tfc/confman.hpp>
+#include <tfc/ipc.hpp>
+#include <tfc/logger.hpp>
+
+#include "config.hpp"
+#include "wire.hpp"
+
+namespace tfc::ipc_bridge {
+
+namespace asio = boost::asio;
+
+/**
+ * @brief
+ * Exports local signals over TCP. Each exported signal is received by a slot on this node, its values are batched
+ * and published to every connected importer. An importer which (re)connects subscribes to a snapshot topic of its
+ * own and is answered with the last value of every exported signal.
+ */
+class exporter {
+public:
+  exporter(asio::io_context& ctx, config const& settings, tfc::logger::logger& logger);
+
+private:
+  void export_signal(std::string_view full_name);
+
+  template <typename slot_t>
+  auto forward(std::shared_ptr<slot_t> slot, std::size_t idx) -> asio::awaitable<void>;
+
+  void schedule_flush();
+
+  /// \brief publish the values which have changed since the last flush
+  void flush();
+
+  /// \brief publish the values in one message on topic
+  void publish(std::string_view topic, bool changed_only);
+
+  void handle_subscription(std::error_code const& error_code, std::size_t bytes_received);
+
+  void register_handle_subscription();
+
+  asio::io_context& ctx_;
+  tfc::logger::logger& logger_;
+  std::chrono::milliseconds batch_window_;
+  azmq::xpub_socket socket_;
+  asio::steady_timer flush_timer_;
+  bool flush_pending_{ false };
+  std::vector<ipc::details::any_slot> slots_{};
+  std::vector<wire::entry> entries_{};
+  std::vector<asio::const_buffer> batch_{};
+  std::array<std::byte, 256> subscription_buffer_{};
+};
+
+/**
+ * @brief
+ * Imports the signals a peer exports and re-publishes them on this node under the same names, registered with the
+ * ipc-ruler of this node. Reconnecting is left to zmq, which re-sends the subscriptions of the importer and thereby
+ * gets the snapshot of the exporter re-sent.
+ */
+class importer {
+public:
+  importer(asio::io_context& ctx,
+           ipc_ruler::ipc_manager_client& client,
+           peer const& remote,
+           config const& settings,
+           tfc::logger::logger& logger);
+
+private:
+  void register_read();
+
+  void handle_batch(std::error_code const& error_code, azmq::message& topic_message);
+
+  void publish(std::string_view full_name, std::span<std::byte const> header, std::span<std::byte const> value);
+
+  auto make_signal(std::string_view full_name) -> ipc::details::any_signal;
+
+  /// \return topic unique to this connection across nodes
+  static auto make_snapshot_topic() -> std::string;
+
+  struct string_hash {
+    using is_transparent = void;
+    auto operator()(std::string_view key) const noexcept -> std::size_t { return std::hash<std::string_view>{}(key); }
+  };
+
+  asio::io_context& ctx_;
+  ipc_ruler::ipc_manager_client& client_;
+  tfc::logger::logger& logger_;
+  std::string endpoint_;
+  std::string snapshot_topic_;
+  azmq::sub_socket socket_;
+  std::vector<azmq::message> parts_{};
+  std::vector<std::span<std::byte const>> frames_{};
+  // monostate for names which could not be re-published, so they are only reported once
+  std::unordered_map<std::string, ipc::details::any_signal, string_hash, std::equal_to<>> signals_{};
+};
+
+class bridge {
+public:
+  explicit bridge(asio::io_context& ctx);
+
+private:
+  asio::io_context& ctx_;
+  tfc::logger::logger logger_;
+  tfc::confman::config<config> config_;
+  ipc_ruler::ipc_manager_client client_;
+  std::optional<exporter> exporter_{};
+  std::vector<std::unique_ptr<importer>> importers_{};
+};
+
+}  // namespace tfc::ipc_bridge
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <tfc/confman.hpp>
+#include <tfc/stx/glaze_meta.hpp>
+
+namespace tfc::ipc_bridge {
+
+struct peer {
+  std::string address{};
+  std::uint16_t port{};
+  struct glaze {
+    static constexpr std::string_view name{ "tfc::ipc_bridge::peer" };
+    // clang-format off
+    static constexpr auto value{ glz::object(
+      "address", &peer::address, "Hostname or IP address of the node exporting signals",
+      "port", &peer::port, "Port the peer exports on"
+    ) };
+    // clang-format on
+  };
+};
+
+// File under /etc/tfc/ipc-bridge/def/ipc_bridge.json
+struct config {
+  std::uint16_t listen_port{};
+  std::vector<std::string> exports{};
+  std::vector<peer> peers{};
+  std::chrono::milliseconds batch_window{ 0 };
+  std::int32_t send_buffer{ 0 };
+  std::int32_t send_high_water_mark{ 10000 };
+  std::chrono::milliseconds reconnect_interval{ 100 };
+  std::chrono::milliseconds reconnect_interval_max{ 2000 };
+  std::chrono::milliseconds heartbeat_interval{ 500 };
+
+  struct glaze {
+    // clang-format off
+    static constexpr auto value{ glz::object(
+        "listen_port", &config::listen_port, "TCP port to export signals on, 0 disables exporting",
+        "exports", &config::exports, "Full names of the local signals to export, example: tfcctl.def.bool.my_signal",
+        "peers", &config::peers, "Nodes to import signals from, they are re-published here under the same names",
+        "batch_window", &config::batch_window, "Values changed within this window are sent as one message, 0 is per loop",
+        "send_buffer", &config::send_buffer, "Kernel send buffer size in bytes of the export socket, 0 is the OS default",
+        "send_high_water_mark", &config::send_high_water_mark, "Batches queued per peer before new ones are dropped",
+        "reconnect_interval", &config::reconnect_interval, "Initial interval between reconnect attempts to a peer",
+        "reconnect_interval_max", &config::reconnect_interval_max, "Reconnect attempts back off up to this interval",
+        "heartbeat_interval", &config::heartbeat_interval, "Interval of heartbeats detecting a lost peer, 0 disables them"
+      ) };
+    // clang-format on
+    static constexpr std::string_view name{ "ipc_bridge" };
+  };
+};
+
+}  // namespace tfc::ipc_bridge
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+#include <tfc/ipc/enums.hpp>
+#include <tfc/stx/concepts.hpp>
+
+/// Wire format of the bridge, one zmq multipart message per batch:
+///   [topic][name][header][value] ... [name][header][value]
+/// The topic is value_topic for values which have changed, or a snapshot topic unique to an importer connection for the
+/// resync sent when it (re)subscribes. Header and value are the parts of a tfc::ipc::details::packet.
+namespace tfc::ipc_bridge::wire {
+
+namespace asio = boost::asio;
+
+static constexpr std::string_view value_topic{ "v" };
+static constexpr char snapshot_topic_prefix{ '\xff' };
+// zmq matches subscriptions by prefix, the terminator keeps the topic of one importer from prefixing another's
+static constexpr char snapshot_topic_terminator{ '|' };
+static constexpr std::size_t frames_per_value{ 3 };
+
+/// \brief full name of a signal split into its parts, <exe>.<proc>.<type>.<name>
+struct signal_name {
+  std::string_view owner{};  // <exe>.<proc>
+  ipc::details::type_e type{ ipc::details::type_e::unknown };
+  std::string_view name{};
+};
+
+/// \return parts of full_name, nullopt if it is not the name of a signal
+constexpr auto parse_signal_name(std::string_view full_name) -> std::optional<signal_name> {
+  auto const exe_end{ full_name.find('.') };
+  if (exe_end == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto const proc_end{ full_name.find('.', exe_end + 1) };
+  if (proc_end == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto const type_end{ full_name.find('.', proc_end + 1) };
+  if (type_end == std::string_view::npos || type_end + 1 == full_name.size()) {
+    return std::nullopt;
+  }
+  auto const type_name{ full_name.substr(proc_end + 1, type_end - proc_end - 1) };
+  auto const type{ ipc::details::enum_cast(type_name) };
+  if (type == ipc::details::type_e::unknown || ipc::details::enum_name(type) != type_name) {
+    return std::nullopt;
+  }
+  return signal_name{ .owner = full_name.substr(0, proc_end), .type = type, .name = full_name.substr(type_end + 1) };
+}
+
+static_assert(parse_signal_name("tfcctl.def.bool.foo").has_value());
+static_assert(parse_signal_name("tfcctl.def.bool.foo")->owner == "tfcctl.def");
+static_assert(parse_signal_name("tfcctl.def.uint64_t.foo")->type == ipc::details::type_e::_uint64_t);
+static_assert(parse_signal_name("tfcctl.def.int64_t.foo.bar")->name == "foo.bar");
+static_assert(!parse_signal_name("tfcctl.def.bool.").has_value());
+static_assert(!parse_signal_name("tfcctl.def.boolean.foo").has_value());
+static_assert(!parse_signal_name("bool.foo").has_value());
+
+/// \brief last value of an exported signal in wire form, kept so it can be resent on resync
+struct entry {
+  std::string name{};
+  std::vector<std::byte> header{};
+  std::vector<std::byte> value{};
+  bool changed{ false };
+
+  [[nodiscard]] auto has_value() const noexcept -> bool { return !header.empty(); }
+};
+
+/// \brief append the frames of the entry to a batch, the entry needs to outlive the batch
+inline void append(std::vector<asio::const_buffer>& batch, entry const& exported) {
+  batch.emplace_back(exported.name.data(), exported.name.size());
+  batch.emplace_back(exported.header.data(), exported.header.size());
+  batch.emplace_back(exported.value.data(), exported.value.size());
+}
+
+/// \brief invoke visitor with name, header and value of each value in the frames of a batch following its topic
+/// \return std::errc::bad_message if the frames do not add up to whole values, none of them are visited then
+auto for_each_value(std::span<std::span<std::byte const> const> frames,
+                    tfc::stx::invocable<std::string_view, std::span<std::byte const>, std::span<std::byte const>> auto&&
+                        visitor) -> std::error_code {
+  if (frames.size() % frames_per_value != 0) {
+    return std::make_error_code(std::errc::bad_message);
+  }
+  for (std::size_t idx{ 0 }; idx < frames.size(); idx += frames_per_value) {
+    auto const name{ frames[idx] };
+    visitor(std::string_view{ reinterpret_cast<char const*>(name.data()), name.size() }, frames[idx + 1], frames[idx + 2]);
+  }
+  return {};
+}
+
+}  // namespace tfc::ipc_bridge::wire
@@ -0,0 +1,305 @@
+#include <atomic>
+#include <expected>
+#include <utility>
+
+#include <unistd.h>
+
+#include <fmt/format.h>
+#include <boost/asio/experimental/as_tuple.hpp>
+
+#include <tfc/utils/socket.hpp>
+
+#include "bridge.hpp"
+
+namespace tfc::ipc_bridge {
+
+namespace {
+// options azmq does not name, detects a lost peer on connections which are otherwise idle
+using heartbeat_ivl = azmq::opt::integer<ZMQ_HEARTBEAT_IVL>;
+
+template <typename type_desc>
+auto republish(asio::io_context& ctx, wire::signal_name const& parsed)
+    -> std::expected<ipc::details::any_signal, std::error_code> {
+  auto created{ ipc::details::signal<type_desc>::create(ctx, parsed.owner, parsed.name) };
+  if (!created) {
+    return std::unexpected(created.error());
+  }
+  return std::move(created.value());
+}
+}  // namespace
+
+exporter::exporter(asio::io_context& ctx, config const& settings, tfc::logger::logger& logger)
+    : ctx_{ ctx }, logger_{ logger }, batch_window_{ settings.batch_window }, socket_{ ctx }, flush_timer_{ ctx } {
+  if (settings.send_buffer > 0) {
+    socket_.set_option(azmq::socket::snd_buf{ settings.send_buffer });
+  }
+  socket_.set_option(azmq::socket::snd_hwm{ settings.send_high_water_mark });
+  socket_.set_option(heartbeat_ivl{ static_cast<int>(settings.heartbeat_interval.count()) });
+  socket_.bind(utils::socket::zmq::tcp_endpoint_str("*", settings.listen_port));
+
+  entries_.reserve(settings.exports.size());
+  slots_.reserve(settings.exports.size());
+  for (auto const& full_name : settings.exports) {
+    export_signal(full_name);
+  }
+  register_handle_subscription();
+}
+
+void exporter::export_signal(std::string_view full_name) {
+  auto const parsed{ wire::parse_signal_name(full_name) };
+  if (!parsed) {
+    logger_.warn("Not exporting: '{}', it is not the full name of a signal", full_name);
+    return;
+  }
+  auto slot{ ipc::details::make_any_slot::make(parsed->type, ctx_, fmt::format("ipc_bridge.{}", full_name)) };
+  std::visit(
+      [this, full_name]<typename receiver_t>(receiver_t& receiver) {
+        if constexpr (!std::same_as<receiver_t, std::monostate>) {
+          if (auto error{ receiver->connect(full_name) }) {
+            logger_.warn("Unable to connect to: '{}', error: '{}'", full_name, error.message());
+            return;
+          }
+          auto const idx{ entries_.size() };
+          entries_.emplace_back(wire::entry{ .name = std::string{ full_name } });
+          asio::co_spawn(ctx_, forward(receiver, idx), asio::detached);
+        }
+      },
+      slot);
+  slots_.emplace_back(std::move(slot));
+}
+
+template <typename slot_t>
+auto exporter::forward(std::shared_ptr<slot_t> slot, std::size_t idx) -> asio::awaitable<void> {
+  using packet_t = typename slot_t::packet_t;
+  typename slot_t::value_t value{};
+  typename packet_t::header_buffer_t header_buffer{};
+  for (;;) {
+    auto [error] = co_await slot->async_receive_into(value, asio::experimental::as_tuple(asio::use_awaitable));
+    if (error == std::errc::operation_canceled) {
+      co_return;
+    }
+    if (error) {
+      logger_.warn("Dropping value of: '{}', error: '{}'", entries_[idx].name, error.message());
+      continue;
+    }
+    // The header of the signal is passed on, keeping its sequence and crc
+    auto const buffers{ packet_t::serialize(value, header_buffer, slot->last_header()) };
+    auto& exported{ entries_[idx] };
+    exported.header.assign(buffers[0].begin(), buffers[0].end());
+    exported.value.assign(buffers[1].begin(), buffers[1].end());
+    exported.changed = true;
+    schedule_flush();
+  }
+}
+
+void exporter::schedule_flush() {
+  if (flush_pending_) {
+    return;
+  }
+  flush_pending_ = true;
+  if (batch_window_ == std::chrono::milliseconds::zero()) {
+    // everything received within this cycle of the event loop goes into the same batch
+    asio::post(ctx_, [this] { flush(); });
+    return;
+  }
+  flush_timer_.expires_after(batch_window_);
+  flush_timer_.async_wait([this](std::error_code const& error) {
+    if (!error) {
+      flush();
+    }
+  });
+}
+
+void exporter::flush() {
+  flush_pending_ = false;
+  publish(wire::value_topic, true);
+}
+
+void exporter::publish(std::string_view topic, bool changed_only) {
+  batch_.clear();
+  batch_.emplace_back(topic.data(), topic.size());
+  for (auto& exported : entries_) {
+    if (!exported.has_value() || (changed_only && !exported.changed)) {
+      continue;
+    }
+    if (changed_only) {
+      exported.changed = false;
+    }
+    wire::append(batch_, exported);
+  }
+  if (batch_.size() == 1) {
+    return;
+  }
+  // Never blocks, a peer which has fallen behind by send_high_water_mark batches misses new ones until it catches up
+  boost::system::error_code send_error;
+  socket_.send(batch_, 0, send_error);
+  if (send_error) {
+    logger_.warn("Unable to publish batch on topic: '{}', error: '{}'", topic, send_error.message());
+  }
+}
+
+void exporter::handle_subscription(std::error_code const& error_code, std::size_t bytes_received) {
+  if (error_code) {
+    return;  // the socket is closing
+  }
+  // Subscription messages are a subscribe(1)/unsubscribe(0) byte followed by the topic
+  std::span<std::byte const> const message{ subscription_buffer_.data(),
+                                            std::min(bytes_received, subscription_buffer_.size()) };
+  if (message.size() > 1 && message[0] == std::byte{ 1 } && static_cast<char>(message[1]) == wire::snapshot_topic_prefix) {
+    auto const topic{ message.subspan(1) };
+    logger_.trace("Sending snapshot of {} signals", entries_.size());
+    publish(std::string_view{ reinterpret_cast<char const*>(topic.data()), topic.size() }, false);
+  }
+  register_handle_subscription();
+}
+
+void exporter::register_handle_subscription() {
+  socket_.async_receive(asio::buffer(subscription_buffer_),
+                        [this](std::error_code const& error_code, std::size_t bytes_received) {
+                          handle_subscription(error_code, bytes_received);
+                        });
+}
+
+importer::importer(asio::io_context& ctx,
+                   ipc_ruler::ipc_manager_client& client,
+                   peer const& remote,
+                   config const& settings,
+                   tfc::logger::logger& logger)
+    : ctx_{ ctx }, client_{ client }, logger_{ logger },
+      endpoint_{ utils::socket::zmq::tcp_endpoint_str(remote.address, remote.port) },
+      snapshot_topic_{ make_snapshot_topic() }, socket_{ ctx, true } {
+  socket_.set_option(azmq::socket::reconnect_ivl{ static_cast<int>(settings.reconnect_interval.count()) });
+  socket_.set_option(azmq::socket::reconnect_ivl_max{ static_cast<int>(settings.reconnect_interval_max.count()) });
+  socket_.set_option(heartbeat_ivl{ static_cast<int>(settings.heartbeat_interval.count()) });
+  socket_.set_option(azmq::socket::subscribe(wire::value_topic.data(), wire::value_topic.size()));
+  // Sent on every (re)connect, the exporter answers it with the last value of each exported signal
+  socket_.set_option(azmq::socket::subscribe(snapshot_topic_));
+  socket_.connect(endpoint_);
+  logger_.info("Importing signals from: '{}'", endpoint_);
+  register_read();
+}
+
+void importer::register_read() {
+  socket_.async_receive([this](boost::system::error_code const& error_code, azmq::message& topic_message, std::size_t) {
+    handle_batch(error_code, topic_message);
+  });
+}
+
+void importer::handle_batch(std::error_code const& error_code, azmq::message& topic_message) {
+  if (error_code == std::errc::operation_canceled) {
+    return;
+  }
+  if (error_code) {
+    logger_.warn("Receiving from: '{}' failed, error: '{}'", endpoint_, error_code.message());
+    register_read();
+    return;
+  }
+  // A multipart message is delivered atomically, the remaining parts are already queued
+  std::size_t count{ 0 };
+  bool more{ topic_message.more() };
+  while (more) {
+    if (count == parts_.size()) {
+      parts_.emplace_back();
+    }
+    boost::system::error_code receive_error;
+    socket_.receive(parts_[count], ZMQ_DONTWAIT, receive_error);
+    if (receive_error) {
+      break;
+    }
+    more = parts_[count].more();
+    count++;
+  }
+  frames_.clear();
+  for (std::size_t idx{ 0 }; idx < count; idx++) {
+    frames_.emplace_back(static_cast<std::byte const*>(parts_[idx].data()), parts_[idx].size());
+  }
+  if (auto error{ wire::for_each_value(frames_, std::bind_front(&importer::publish, this)) }) {
+    logger_.warn("Discarding malformed batch of {} frames from: '{}'", count, endpoint_);
+  }
+  register_read();
+}
+
+void importer::publish(std::string_view full_name, std::span<std::byte const> header, std::span<std::byte const> value) {
+  auto found{ signals_.find(full_name) };
+  if (found == signals_.end()) {
+    found = signals_.emplace(std::string{ full_name }, make_signal(full_name)).first;
+  }
+  std::visit(
+      [this, full_name, header, value]<typename sender_t>(sender_t& sender) {
+        if constexpr (!std::same_as<sender_t, std::monostate>) {
+          using signal_t = typename sender_t::element_type;
+          typename signal_t::value_t received{};
+          if (auto error{ signal_t::packet_t::deserialize_into(received, header, value) }) {
+            logger_.warn("Dropping value of: '{}', error: '{}'", full_name, error.message());
+            return;
+          }
+          if (auto error{ sender->send(received) }) {
+            logger_.warn("Unable to re-publish value of: '{}', error: '{}'", full_name, error.message());
+          }
+        }
+      },
+      found->second);
+}
+
+auto importer::make_signal(std::string_view full_name) -> ipc::details::any_signal {
+  auto const parsed{ wire::parse_signal_name(full_name) };
+  if (!parsed) {
+    logger_.warn("Not re-publishing: '{}', it is not the full name of a signal", full_name);
+    return std::monostate{};
+  }
+  std::expected<ipc::details::any_signal, std::error_code> created{};
+  switch (parsed->type) {
+    using enum ipc::details::type_e;
+    case _bool:
+      created = republish<ipc::details::type_bool>(ctx_, parsed.value());
+      break;
+    case _int64_t:
+      created = republish<ipc::details::type_int>(ctx_, parsed.value());
+      break;
+    case _uint64_t:
+      created = republish<ipc::details::type_uint>(ctx_, parsed.value());
+      break;
+    case _double_t:
+      created = republish<ipc::details::type_double>(ctx_, parsed.value());
+      break;
+    case _string:
+      created = republish<ipc::details::type_string>(ctx_, parsed.value());
+      break;
+    case _json:
+      created = republish<ipc::details::type_json>(ctx_, parsed.value());
+      break;
+    case unknown:
+      return std::monostate{};
+  }
+  if (!created) {
+    logger_.warn("Unable to re-publish: '{}', error: '{}'", full_name, created.error().message());
+    return std::monostate{};
+  }
+  client_.register_signal(full_name, fmt::format("Bridged from {}", endpoint_), parsed->type,
+                          [this, name = std::string{ full_name }](std::error_code const& error) {
+                            if (error) {
+                              logger_.warn("Unable to register: '{}' with ipc-ruler, error: '{}'", name, error.message());
+                            }
+                          });
+  logger_.info("Re-publishing: '{}' from: '{}'", full_name, endpoint_);
+  return std::move(created.value());
+}
+
+auto importer::make_snapshot_topic() -> std::string {
+  static std::atomic<std::uint64_t> counter{};
+  return fmt::format("{}{}.{}.{}{}", wire::snapshot_topic_prefix, asio::ip::host_name(), getpid(), counter.fetch_add(1),
+                     wire::snapshot_topic_terminator);
+}
+
+bridge::bridge(asio::io_context& ctx)
+    : ctx_{ ctx }, logger_{ "ipc-bridge" }, config_{ ctx, "ipc_bridge" }, client_{ ctx } {
+  if (config_->listen_port != 0) {
+    exporter_.emplace(ctx_, config_.value(), logger_);
+    logger_.info("Exporting {} signals on port {}", config_->exports.size(), config_->listen_port);
+  }
+  for (auto const& remote : config_->peers) {
+    importers_.emplace_back(std::make_unique<importer>(ctx_, client_, remote, config_.value(), logger_));
+  }
+}
+
+}  // namespace tfc::ipc_bridge
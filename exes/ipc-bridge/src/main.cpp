@@ -0,0 +1,23 @@
+#include <cstdlib>
+
+#include <boost/asio.hpp>
+
+#include <tfc/progbase.hpp>
+
+#include "bridge.hpp"
+
+namespace asio = boost::asio;
+
+auto main(int argc, char** argv) -> int {
+  tfc::base::init(argc, argv);
+
+  asio::io_context ctx{};
+
+  [[maybe_unused]] tfc::ipc_bridge::bridge const instance{ ctx };
+
+  asio::co_spawn(ctx, tfc::base::exit_signals(ctx), asio::detached);
+
+  ctx.run();
+
+  return EXIT_SUCCESS;
+}
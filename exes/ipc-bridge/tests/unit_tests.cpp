@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <boost/ut.hpp>
+#include <tfc/ipc/packet.hpp>
+
+#include "wire.hpp"
+
+namespace ut = boost::ut;
+using boost::ut::operator""_test;
+using boost::ut::operator>>;
+using boost::ut::fatal;
+
+namespace wire = tfc::ipc_bridge::wire;
+
+auto main() -> int {
+  "batched values are visited in order"_test = [] {
+    using packet_t = tfc::ipc::details::packet<std::int64_t, tfc::ipc::details::type_e::_int64_t>;
+    std::vector<wire::entry> entries{};
+    for (std::int64_t value : { 1, 2 }) {
+      packet_t::header_buffer_t header_buffer{};
+      auto const buffers{ packet_t::serialize(value, header_buffer) };
+      entries.emplace_back(wire::entry{ .name = fmt::format("exe.proc.int64_t.value_{}", value),
+                                        .header = { buffers[0].begin(), buffers[0].end() },
+                                        .value = { buffers[1].begin(), buffers[1].end() } });
+    }
+    std::vector<boost::asio::const_buffer> batch{};
+    for (auto const& exported : entries) {
+      wire::append(batch, exported);
+    }
+    ut::expect(batch.size() == 2 * wire::frames_per_value);
+
+    std::vector<std::span<std::byte const>> frames{};
+    for (auto const& buffer : batch) {
+      frames.emplace_back(static_cast<std::byte const*>(buffer.data()), buffer.size());
+    }
+    std::vector<std::string> names{};
+    std::vector<std::int64_t> values{};
+    auto const error{ wire::for_each_value(frames, [&](std::string_view name, auto header, auto value) {
+      names.emplace_back(name);
+      std::int64_t received{};
+      ut::expect(!packet_t::deserialize_into(received, header, value));
+      values.emplace_back(received);
+    }) };
+    ut::expect(!error);
+    ut::expect(names == std::vector<std::string>{ "exe.proc.int64_t.value_1", "exe.proc.int64_t.value_2" });
+    ut::expect(values == std::vector<std::int64_t>{ 1, 2 });
+  };
+
+  "malformed batches are not visited"_test = [] {
+    std::vector<std::byte> const bytes{ std::byte{ 1 } };
+    std::vector<std::span<std::byte const>> const frames{ bytes, bytes };
+    std::size_t visited{};
+    auto const error{ wire::for_each_value(frames, [&visited](std::string_view, auto, auto) { visited++; }) };
+    ut::expect(error == std::errc::bad_message);
+    ut::expect(visited == 0);
+  };
+
+  "signal names"_test = [] {
+    auto const parsed{ wire::parse_signal_name("tfcctl.def.json.line.speed") };
+    ut::expect(parsed.has_value() >> fatal);
+    ut::expect(parsed->owner == "tfcctl.def");
+    ut::expect(parsed->type == tfc::ipc::details::type_e::_json);
+    ut::expect(parsed->name == "line.speed");
+    ut::expect(!wire::parse_signal_name("tfcctl.def").has_value());
+  };
+
+  return 0;
+}
@@ -1,3 +1,11 @@
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <tuple>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <tfc/confman/file_storage.hpp>
 #include <tfc/ipc/details/dbus_server_iface.hpp>
@@ -7,15 +15,23 @@ auto main(int argc, char** argv) -> int {
 
   boost::asio::io_context ctx;
 
-  using signal_storage = tfc::confman::file_storage<std::map<std::string, tfc::ipc_ruler::signal>>;
-  using slot_storage = tfc::confman::file_storage<std::map<std::string, tfc::ipc_ruler::slot>>;
+  // std::less<> lets ipc_manager look entries up by std::string_view
+  using signal_storage = tfc::confman::file_storage<std::map<std::string, tfc::ipc_ruler::signal, std::less<>>>;
+  using slot_storage = tfc::confman::file_storage<std::map<std::string, tfc::ipc_ruler::slot, std::less<>>>;
 
   auto signals = signal_storage(ctx, tfc::base::make_config_file_name("signal", "json"));
   auto slots = slot_storage(ctx, tfc::base::make_config_file_name("slots", "json"));
+  // Registrations arrive in bursts at startup, write them once the burst is over
+  signals.write_behind(std::chrono::milliseconds{ 500 });
+  slots.write_behind(std::chrono::milliseconds{ 500 });
 
   auto ipc_manager = std::make_unique<tfc::ipc_ruler::ipc_manager<signal_storage, slot_storage>>(signals, slots);
 
   tfc::ipc_ruler::ipc_manager_server<signal_storage, slot_storage> const dbus_ipc_server(ctx, std::move(ipc_manager));
 
+  boost::asio::co_spawn(ctx, tfc::base::exit_signals(ctx), boost::asio::detached);
   ctx.run();
+
+  std::ignore = signals.flush();
+  std::ignore = slots.flush();
 }
@@ -4,6 +4,8 @@
 #include <any>
 #include <chrono>
 #include <concepts>
+#include <cstddef>
+#include <deque>
 #include <exception>
 #include <memory>
 #include <optional>
@@ -21,7 +23,6 @@
 #include <async_mqtt/all.hpp>
 #include <boost/asio.hpp>
 #include <boost/asio/experimental/as_tuple.hpp>
-#include <sdbusplus/bus/match.hpp>
 #include <tfc/dbus/string_maker.hpp>
 
 #include "config.hpp"
@@ -74,8 +75,15 @@ public:
   explicit mqtt_broadcaster(asio::io_context& io_ctx) : io_ctx_(io_ctx) {}
 
   auto run() -> void {
-    properties_callback_ = ipc_client_.register_properties_change_callback(
-        [this]([[maybe_unused]] sdbusplus::message_t& msg) { add_new_signals(); });
+    // The directory follows the changes of the ipc ruler, signals are added as they are registered
+    auto& directory{ ipc_client_.directory() };
+    for (auto const& [name, signal] : directory.signals()) {
+      add_signal(signal);
+    }
+    directory.on_signal_added([this](tfc::ipc_ruler::signal const& signal) { add_signal(signal); });
+    directory.on_signal_removed([this](tfc::ipc_ruler::signal const& signal) {
+      outgoing_logger_.info("Signal {} is no longer registered, its metric is kept until restart", signal.name);
+    });
     asio::co_spawn(mqtt_client_->strand(), initialize(), asio::detached);
     io_ctx_.run();
   }
@@ -84,7 +92,8 @@ private:
   auto initialize() -> asio::awaitable<void> {
     create_scada_signals();
     co_await connect_to_broker();
-    add_new_signals();
+    broker_connected_ = true;
+    request_birth();
     co_await ncmd_listener();
   }
 
@@ -456,51 +465,54 @@ private:
     }
   }
 
-  auto add_new_signals() -> void {
-    outgoing_logger_.trace("Starting to add new signals...");
-
-    ipc_client_.signals([this](const std::vector<tfc::ipc_ruler::signal>& signals) -> void {
-      outgoing_logger_.trace("Received {} new signals to add.", signals.size());
-
-      signals_.clear();
-      signals_.reserve(signals.size());
-      for (auto signal : signals) {
-        // slot must include type name
-        std::string slot_name{ fmt::format("{}_slot_mqtt_broadcaster_{}", ipc::details::enum_name(signal.type),
-                                           signal.name) };
-        auto ipc = tfc::ipc::details::make_any_slot::make(signal.type, io_ctx_, slot_name);
-
-        std::visit(
-            [&](auto&& receiver) -> void {
-              using receiver_t = std::remove_cvref_t<decltype(receiver)>;
-              if constexpr (!std::same_as<receiver_t, std::monostate>) {
-                auto error_code = receiver->connect(signal.name);
-                if (error_code) {
-                  outgoing_logger_.trace("Error connecting to signal: {}, error: {}", signal.name, error_code.message());
-                }
-              }
-            },
-            ipc);
-
-        signals_.emplace_back(signal, std::move(ipc), std::nullopt);
+  auto add_signal(tfc::ipc_ruler::signal const& signal) -> void {
+    // A signal which is removed and registered again, or reported again after the directory resynchronizes, keeps its
+    // metric and receiver, see on_signal_removed in run()
+    auto const same_name{ [&signal](signal_data const& known) { return known.information.name == signal.name; } };
+    if (std::ranges::any_of(signals_, same_name)) {
+      outgoing_logger_.trace("Signal {} already has a metric", signal.name);
+      return;
+    }
+    // slot must include type name
+    std::string slot_name{ fmt::format("{}_slot_mqtt_broadcaster_{}", ipc::details::enum_name(signal.type), signal.name) };
+    auto ipc = tfc::ipc::details::make_any_slot::make(signal.type, io_ctx_, slot_name);
+
+    std::visit(
+        [&](auto&& receiver) -> void {
+          using receiver_t = std::remove_cvref_t<decltype(receiver)>;
+          if constexpr (!std::same_as<receiver_t, std::monostate>) {
+            auto error_code = receiver->connect(signal.name);
+            if (error_code) {
+              outgoing_logger_.trace("Error connecting to signal: {}, error: {}", signal.name, error_code.message());
+            }
+          }
+        },
+        ipc);
 
-        outgoing_logger_.trace("Added signal_data for signal: {}", signal.name);
-      }
+    signals_.emplace_back(signal, std::move(ipc), std::nullopt);
 
-      outgoing_logger_.trace("All new signals added. Preparing to send NBIRTH and start signals...");
+    outgoing_logger_.trace("Added signal_data for signal: {}", signal.name);
 
-      // this function is necessary because it is not possible to co_await inside the signals handler
-      asio::co_spawn(mqtt_client_->strand(), send_nbirth_and_start_signals(), asio::detached);
+    request_birth();
+  }
 
-      outgoing_logger_.trace("Sent NBIRTH and started signals.");
-    });
+  // The NBIRTH lists every metric, so it is sent again when signals are added.
+  // Signals added before the posted NBIRTH is sent share it, none is sent before the broker is connected.
+  auto request_birth() -> void {
+    if (!broker_connected_ || std::exchange(birth_requested_, true)) {
+      return;
+    }
+    // this function is necessary because it is not possible to co_await inside the directory callbacks
+    asio::co_spawn(mqtt_client_->strand(), send_nbirth_and_start_signals(), asio::detached);
   }
 
   auto send_nbirth_and_start_signals() -> asio::awaitable<void> {
+    birth_requested_ = false;
     co_await asio::co_spawn(mqtt_client_->strand(), send_nbirth(), asio::use_awaitable);
 
-    for (auto& signal : signals_) {
-      asio::co_spawn(mqtt_client_->strand(), receive_and_send_message(signal), asio::detached);
+    // signals_ is a deque, the references given to the receivers stay valid as signals are added
+    for (; started_signals_ < signals_.size(); started_signals_++) {
+      asio::co_spawn(mqtt_client_->strand(), receive_and_send_message(signals_[started_signals_]), asio::detached);
     }
   }
 
@@ -579,7 +591,9 @@ private:
 
     outgoing_logger_.info("Node rebirth metric added to the payload");
 
-    for (signal_data& signal_data : signals_) {
+    // by index, signals may be added while waiting for an initial value
+    for (std::size_t idx = 0; idx < signals_.size(); idx++) {
+      signal_data& signal_data{ signals_[idx] };
       outgoing_logger_.info("signals: Processing signal_data: {}", signal_data.information.name);
       auto* variable_metric = payload.add_metrics();
       variable_metric->set_name(format_signal_name(signal_data.information.name));
@@ -709,9 +723,14 @@ private:
 
   network_manager_type network_manager_{};
 
-  std::vector<signal_data> signals_;
+  std::deque<signal_data> signals_;
+
+  // signals_ before this index are received and sent as NDATA
+  std::size_t started_signals_{ 0 };
+
+  bool broker_connected_{ false };
 
-  std::unique_ptr<sdbusplus::bus::match::match> properties_callback_;
+  bool birth_requested_{ false };
 
   uint64_t seq_ = 0;
 
@@ -76,10 +76,8 @@ template <template <typename, typename> typename signal_t, template <typename, t
 // clang-format on
 void state_machine_owner<signal_t, slot_t, sml_t>::enter_starting() {
   if (config_->startup_time) {
-    auto timer{ std::make_shared<asio::steady_timer>(ctx_) };
-    timer->expires_after(config_->startup_time.value());
-    // todo we should cancel timer if some other event happens
-    timer->async_wait([this, timer](std::error_code const& err) { this->on_starting_timer_expired(err); });
+    starting_timer_ = utils::timing_wheel::of(ctx_).schedule_after(
+        config_->startup_time.value(), [this](std::error_code const& err) { this->on_starting_timer_expired(err); });
   }
   starting_.async_send(true, [this](auto err, auto) {
     if (err)
@@ -90,6 +88,8 @@ void state_machine_owner<signal_t, slot_t, sml_t>::enter_starting() {
 template <template <typename, typename> typename signal_t, template <typename, typename> typename slot_t, template <typename, typename...> typename sml_t>
 // clang-format on
 void state_machine_owner<signal_t, slot_t, sml_t>::leave_starting() {
+  // some other event left starting before the timer expired
+  utils::timing_wheel::of(ctx_).cancel(starting_timer_);
   starting_.async_send(false, [this](auto err, auto) {
     if (err)
       logger_.info("Unable to send starting signal false, error: {}", err.message());
@@ -118,10 +118,8 @@ template <template <typename, typename> typename signal_t, template <typename, t
 // clang-format on
 void state_machine_owner<signal_t, slot_t, sml_t>::enter_stopping() {
   if (config_->stopping_time.has_value()) {
-    auto timer{ std::make_shared<asio::steady_timer>(ctx_) };
-    timer->expires_after(config_->stopping_time.value());
-    // todo we should cancel timer if some other event happens
-    timer->async_wait([this, timer](std::error_code const& err) { this->on_stopping_timer_expired(err); });
+    stopping_timer_ = utils::timing_wheel::of(ctx_).schedule_after(
+        config_->stopping_time.value(), [this](std::error_code const& err) { this->on_stopping_timer_expired(err); });
   }
   stopping_.async_send(true, [this](auto err, auto) {
     if (err)
@@ -132,6 +130,7 @@ void state_machine_owner<signal_t, slot_t, sml_t>::enter_stopping() {
 template <template <typename, typename> typename signal_t, template <typename, typename> typename slot_t, template <typename, typename...> typename sml_t>
 // clang-format on
 void state_machine_owner<signal_t, slot_t, sml_t>::leave_stopping() {
+  utils::timing_wheel::of(ctx_).cancel(stopping_timer_);
   stopping_.async_send(false, [this](auto err, auto) {
     if (err)
       logger_.info("Unable to send stopping signal false, error: {}", err.message());
@@ -13,6 +13,7 @@
 #include <tfc/stx/concepts.hpp>
 #include <tfc/utils/asio_fwd.hpp>
 #include <tfc/utils/pragmas.hpp>
+#include <tfc/utils/timing_wheel.hpp>
 
 namespace tfc::operation {
 
@@ -120,6 +121,8 @@ private:
   tfc::confman::config<detail::storage> config_{ ctx_, "state_machine",
                                                  detail::storage{ .startup_time = std::chrono::milliseconds{ 0 },
                                                                   .stopping_time = std::chrono::milliseconds{ 0 } } };
+  utils::timing_wheel::handle starting_timer_{};
+  utils::timing_wheel::handle stopping_timer_{};
   using state_machine_t = sml_t<detail::state_machine<state_machine_owner>, boost::sml::logger<tfc::logger::sml_logger>>;
   std::shared_ptr<state_machine_t> states_;
 };
@@ -1,10 +1,24 @@
 #pragma once
+#include <fcntl.h>
 #include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <utility>
 
 #include <fmt/format.h>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <glaze/glaze.hpp>
 
 #include <tfc/confman/detail/change.hpp>
@@ -20,6 +34,8 @@ namespace asio = boost::asio;
 /// The type is stored on the disc given the file_path as pretty json string.
 /// If the file is changed while program is running the application detects the change and
 /// changes the member value accordingly.
+/// The file is replaced atomically, a power loss leaves either the former or the new content.
+/// With write_behind() a change is written once after a delay, coalescing the changes made meanwhile.
 template <typename storage_t>
 class file_storage {
 public:
@@ -27,7 +43,8 @@ public:
 
   /// \brief Empty constructor
   /// \note Should only be used for testing !!!
-  explicit file_storage(asio::io_context& ctx) : logger_{ "file_storage" }, file_watcher_{ ctx } {}
+  explicit file_storage(asio::io_context& ctx)
+      : logger_{ "file_storage" }, file_watcher_{ ctx }, flush_timer_{ ctx } {}
 
   /// \brief Construct file storage with default constructed storage_t
   file_storage(asio::io_context& ctx, std::filesystem::path const& file_path)
@@ -36,7 +53,7 @@ public:
   /// \brief Construct file storage with user defined default values for storage_t
   file_storage(asio::io_context& ctx, std::filesystem::path const& file_path, auto&& default_value)
       : config_file_{ file_path }, storage_{ std::forward<decltype(default_value)>(default_value) },
-        logger_{ fmt::format("file_storage.{}", file_path.string()) }, file_watcher_{ ctx } {
+        logger_{ fmt::format("file_storage.{}", file_path.string()) }, file_watcher_{ ctx }, flush_timer_{ ctx } {
     std::filesystem::create_directories(config_file_.parent_path());
     error_ = read_file();
     if (error_) {
@@ -51,16 +68,53 @@ public:
       error_ = std::make_error_code(static_cast<std::errc>(err));
       return;
     }
-    auto const inotify_watch_fd{ inotify_add_watch(inotify_fd, config_file_.c_str(), IN_MODIFY) };
+    // The directory is watched since writing replaces the file, a watch on the file would be lost on the first write
+    auto const inotify_watch_fd{ inotify_add_watch(inotify_fd, config_file_.parent_path().c_str(),
+                                                   IN_CLOSE_WRITE | IN_MOVED_TO) };
     if (inotify_watch_fd < 0) {
       int const err{ errno };
       error_ = std::make_error_code(static_cast<std::errc>(err));
       return;
     }
     file_watcher_.assign(inotify_fd);
-    file_watcher_.async_read_some(asio::null_buffers(), std::bind_front(&file_storage::on_file_change, this));
+    watch();
   }
 
+  /// \brief the pending file watch and write behind of other are taken over, other is left without them
+  file_storage(file_storage&& other) noexcept
+      : config_file_{ std::move(other.config_file_) }, storage_{ std::move(other.storage_) },
+        logger_{ std::move(other.logger_) }, error_{ other.error_ }, file_watcher_{ std::move(other.file_watcher_) },
+        cb_{ std::move(other.cb_) }, write_behind_{ other.write_behind_ }, dirty_{ std::exchange(other.dirty_, false) },
+        flush_timer_{ std::move(other.flush_timer_) }, written_{ other.written_ } {
+    other.alive_ = std::make_shared<bool>();
+    adopt();
+  }
+
+  /// \brief a change of this held back by write_behind is written before other is taken over
+  auto operator=(file_storage&& other) noexcept -> file_storage& {
+    if (this == &other) {
+      return *this;
+    }
+    std::ignore = flush();
+    config_file_ = std::move(other.config_file_);
+    storage_ = std::move(other.storage_);
+    logger_ = std::move(other.logger_);
+    error_ = other.error_;
+    file_watcher_ = std::move(other.file_watcher_);
+    cb_ = std::move(other.cb_);
+    write_behind_ = other.write_behind_;
+    dirty_ = std::exchange(other.dirty_, false);
+    flush_timer_ = std::move(other.flush_timer_);
+    written_ = other.written_;
+    alive_ = std::make_shared<bool>();
+    other.alive_ = std::make_shared<bool>();
+    adopt();
+    return *this;
+  }
+
+  /// \brief a change held back by write_behind is written before destruction
+  ~file_storage() { std::ignore = flush(); }
+
   /// \brief Internal error code
   /// \returns error if something went wrong with filesystem commands
   [[nodiscard]] auto error() const noexcept -> std::error_code const& { return error_; }
@@ -85,20 +139,34 @@ public:
   /// \return change helper struct providing reference to this` value.
   auto make_change() noexcept -> change { return change{ *this }; }
 
-  /// \brief set_changed writes the current value to disc
+  /// \brief set_changed writes the current value to disc, or marks it to be written when write behind
   /// \return error_code if it was unable to write to disc.
   auto set_changed() const noexcept -> std::error_code {
-    std::string buffer{};  // this can throw, meaning memory error
-    glz::write<glz::opts{ .prettify = true }>(storage_, buffer);
-    auto glz_err{ glz::buffer_to_file(buffer, config_file_.string()) };
-    if (glz_err != glz::error_code::none) {
-      logger_.warn(R"(Error: "{}" writing to file: "{}")", glz::write_json(glz_err), config_file_.string());
-      return std::make_error_code(std::errc::io_error);
-      // todo implicitly convert glaze error_code to std::error_code
+    if (write_behind_ == std::chrono::milliseconds::zero()) {
+      return write_file();
+    }
+    if (!std::exchange(dirty_, true)) {
+      // Not restarted by later changes, a steady stream of changes is still written every delay
+      flush_timer_.expires_after(write_behind_);
+      await_flush();
     }
     return {};
   }
 
+  /// \brief Hold changes back and write them once, delay after the first of them
+  /// \param delay zero writes every change right away, the default
+  auto write_behind(std::chrono::milliseconds delay) -> void { write_behind_ = delay; }
+
+  /// \brief write a change held back by write_behind now, before shutting down
+  /// \return error_code if it was unable to write to disc.
+  auto flush() const noexcept -> std::error_code {
+    if (!std::exchange(dirty_, false)) {
+      return {};
+    }
+    flush_timer_.cancel();
+    return write_file();
+  }
+
 protected:
   friend struct detail::change<file_storage>;
 
@@ -106,6 +174,104 @@ protected:
   // the change mechanism relies on this (the friend above)
   auto access() noexcept -> storage_t& { return storage_; }
 
+  // Handlers hold alive_ weakly, it is replaced when the storage is moved so those bound to the former object are dropped
+
+  void watch() {
+    file_watcher_.async_read_some(asio::null_buffers(),
+                                  [this, alive = std::weak_ptr{ alive_ }](std::error_code const& err, std::size_t bytes) {
+                                    if (alive.expired()) {
+                                      return;  // moved, or destroyed
+                                    }
+                                    on_file_change(err, bytes);
+                                  });
+  }
+
+  void await_flush() const {
+    flush_timer_.async_wait([this, alive = std::weak_ptr{ alive_ }](std::error_code const& err) {
+      if (err || alive.expired()) {
+        return;  // flushed, moved or destroyed
+      }
+      std::ignore = flush();
+    });
+  }
+
+  /// \brief restart the operations taken over by a move, their handlers refer to the object moved from
+  void adopt() {
+    if (file_watcher_.is_open()) {
+      file_watcher_.cancel();
+      watch();
+    }
+    if (dirty_) {
+      flush_timer_.cancel();
+      await_flush();
+    }
+  }
+
+  /// \brief write to a temporary file next to the file and rename it over the file
+  auto write_file() const noexcept -> std::error_code {
+    std::string buffer{};  // this can throw, meaning memory error
+    glz::write<glz::opts{ .prettify = true }>(storage_, buffer);
+    auto const temporary{ fmt::format("{}.tmp", config_file_.string()) };
+    auto const fail{ [this](std::string_view operation) {
+      int const err{ errno };
+      logger_.warn(R"(Error: "{}" {} file: "{}")", std::strerror(err), operation, config_file_.string());
+      return std::make_error_code(static_cast<std::errc>(err));
+    } };
+    auto const file_descriptor{ ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (file_descriptor < 0) {
+      return fail("opening temporary");
+    }
+    for (std::string_view remaining{ buffer }; !remaining.empty();) {
+      auto const written{ ::write(file_descriptor, remaining.data(), remaining.size()) };
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        auto const error{ fail("writing temporary") };
+        ::close(file_descriptor);
+        return error;
+      }
+      remaining.remove_prefix(static_cast<std::size_t>(written));
+    }
+    // The content needs to be on disc before the rename is, otherwise a power loss can leave an empty file
+    if (::fsync(file_descriptor) != 0) {
+      auto const error{ fail("syncing temporary") };
+      ::close(file_descriptor);
+      return error;
+    }
+    ::close(file_descriptor);
+    if (std::rename(temporary.c_str(), config_file_.c_str()) != 0) {
+      return fail("renaming temporary to");
+    }
+    written_ = identify(config_file_);
+    if (auto const directory{ ::open(config_file_.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) };
+        directory >= 0) {
+      ::fsync(directory);  // persist the rename
+      ::close(directory);
+    }
+    return {};
+  }
+
+  /// \brief inode and modification time, a file written since, in place or replaced, has another
+  struct file_identity {
+    dev_t device{};
+    ino_t inode{};
+    std::int64_t modified_ns{};
+
+    auto operator==(file_identity const&) const noexcept -> bool = default;
+  };
+
+  static auto identify(std::filesystem::path const& path) noexcept -> std::optional<file_identity> {
+    struct stat file_stat {};
+    if (::stat(path.c_str(), &file_stat) != 0) {
+      return std::nullopt;
+    }
+    return file_identity{ .device = file_stat.st_dev,
+                          .inode = file_stat.st_ino,
+                          .modified_ns = std::int64_t{ file_stat.st_mtim.tv_sec } * 1'000'000'000 +
+                                         std::int64_t{ file_stat.st_mtim.tv_nsec } };
+  }
+
   auto read_file() -> std::error_code {
     std::string buffer{};
     auto glz_err{ glz::read_file_json(storage_, config_file_.string(), buffer) };
@@ -122,17 +288,30 @@ protected:
       fmt::print(stderr, "File watch error: {}\n", err.message());
       return;
     }
-    std::array<char, 1024> buf{};
-    file_watcher_.read_some(asio::buffer(buf));  // discard the data since we only got one watcher per inotify fd
+    alignas(inotify_event) std::array<char, 4096> buf{};
+    auto const length{ file_watcher_.read_some(asio::buffer(buf)) };
 
-    logger_.trace("File change");
-    read_file();
+    // Events of the directory, only the ones naming the file are of interest
+    bool changed{ false };
+    auto const file_name{ config_file_.filename().string() };
+    for (std::size_t offset{ 0 }; offset + sizeof(inotify_event) <= length;) {
+      auto const* event{ reinterpret_cast<inotify_event const*>(buf.data() + offset) };
+      changed = changed || (event->len > 0 && std::string_view{ event->name } == file_name);
+      offset += sizeof(inotify_event) + event->len;
+    }
 
-    if (cb_) {
-      std::invoke(cb_);
+    // A change held back by write behind is newer than the file, it may be the event of the former flush.
+    // The rename of our own write is not a change either, the file is still the one written.
+    if (changed && !dirty_ && (!written_ || identify(config_file_) != written_)) {
+      logger_.trace("File change");
+      read_file();
+
+      if (cb_) {
+        std::invoke(cb_);
+      }
     }
 
-    file_watcher_.async_read_some(asio::null_buffers(), std::bind_front(&file_storage::on_file_change, this));
+    watch();
   }
 
   std::filesystem::path config_file_{};
@@ -141,6 +320,11 @@ protected:
   std::error_code error_{};
   asio::posix::stream_descriptor file_watcher_;
   std::function<void()> cb_{};
+  std::chrono::milliseconds write_behind_{ 0 };
+  mutable bool dirty_{ false };
+  mutable asio::steady_timer flush_timer_;
+  mutable std::optional<file_identity> written_{};  // of the file last written by this storage
+  std::shared_ptr<bool> alive_{ std::make_shared<bool>() };
 };
 
 }  // namespace tfc::confman
@@ -1,3 +1,6 @@
+#include <fstream>
+#include <optional>
+
 #include <boost/asio.hpp>
 #include <boost/ut.hpp>
 #include <glaze/glaze.hpp>
@@ -134,5 +137,73 @@ auto main(int argc, char** argv) -> int {
     ut::expect(called == 1);
   };
 
+  "write behind coalesces changes"_test = [&] {
+    file_testable<test_me> conf{ ctx, file_name, test_me{ .a = observable<int>{ 1 }, .b = "bar" } };
+    conf.write_behind(std::chrono::milliseconds(10));
+    conf.make_change()->a.set(2);
+    conf.make_change()->b = "test";
+
+    glz::json_t json{};
+    std::string buffer{};
+    glz::read_file_json(json, file_name, buffer);
+    ut::expect(static_cast<int>(json["a"].get<double>()) == 1);
+
+    ctx.run_for(std::chrono::milliseconds(20));
+    buffer = {};
+    glz::read_file_json(json, file_name, buffer);
+    ut::expect(static_cast<int>(json["a"].get<double>()) == 2);
+    ut::expect(json["b"].get<std::string>() == "test");
+  };
+
+  "flush writes a held back change"_test = [&] {
+    file_testable<test_me> conf{ ctx, file_name, test_me{ .a = observable<int>{ 1 }, .b = "bar" } };
+    conf.write_behind(std::chrono::hours(1));
+    conf.make_change()->a.set(3);
+    ut::expect(!conf.flush());
+
+    glz::json_t json{};
+    std::string buffer{};
+    glz::read_file_json(json, file_name, buffer);
+    ut::expect(static_cast<int>(json["a"].get<double>()) == 3);
+    ut::expect(!std::filesystem::exists(file_name + ".tmp"));
+  };
+
+  "own writes are not reported as changes of the file"_test = [&] {
+    file_testable<test_me> conf{ ctx, file_name, test_me{ .a = observable<int>{ 1 }, .b = "bar" } };
+    std::size_t changes{};
+    conf.on_change([&changes] { changes++; });
+    conf.make_change()->a.set(2);
+    ctx.run_for(std::chrono::milliseconds(20));
+    ut::expect(changes == 0);
+
+    std::ofstream{ file_name } << R"({"a":5,"b":"bar"})";
+    ctx.run_for(std::chrono::milliseconds(20));
+    ut::expect(changes == 1);
+    ut::expect(conf.value().a == 5);
+  };
+
+  "moved storage takes over the held back change"_test = [&] {
+    std::optional<tfc::confman::file_storage<test_me>> moved{};
+    {
+      tfc::confman::file_storage<test_me> conf{ ctx, file_name, test_me{ .a = observable<int>{ 1 }, .b = "bar" } };
+      conf.write_behind(std::chrono::milliseconds(10));
+      conf.make_change()->a.set(4);
+      moved.emplace(std::move(conf));
+    }  // the moved from storage writes nothing
+
+    glz::json_t json{};
+    std::string buffer{};
+    glz::read_file_json(json, file_name, buffer);
+    ut::expect(static_cast<int>(json["a"].get<double>()) == 1);
+
+    ctx.run_for(std::chrono::milliseconds(20));
+    buffer = {};
+    glz::read_file_json(json, file_name, buffer);
+    ut::expect(static_cast<int>(json["a"].get<double>()) == 4);
+    ut::expect(moved->value().a == 4);
+    moved.reset();
+    std::filesystem::remove(file_name);
+  };
+
   return EXIT_SUCCESS;
 }
@@ -38,6 +38,12 @@ auto constexpr register_cb(std::string const& ipc_name) {
  * This is the receiving end for tfc's ipc communications,
  * it listens to connection changes from ipc-ruler in
  * addition with implementing the ipc connection.
+ * Thread safety: constructed from an io_context the slot is single threaded. Constructed from a strand its receive
+ * operations, filters, callback and dbus value emission run on the strand, so the io_context may be run by several
+ * threads. Slots sharing a dbus connection need to share the strand, as the connection is not thread safe.
+ * Reads of the dbus properties and the History method are handled on the threads running the io_context, they see the
+ * value as of the last value received and the statistics as of the first value received after they were last read,
+ * see details::dbus_slot.
  * @tparam type_desc The type description for the slot.
  */
 template <typename type_desc, typename manager_client_type = tfc::ipc_ruler::ipc_manager_client&>
@@ -53,21 +59,21 @@ public:
    * @param client manager_client_type a reference to a manager client
    * @param name The slot name
    * @param callback Channel for value updates from the corresponding signal.
+   * @param policy receive_policy_e::latest makes a slow consumer skip values which queued up while it was busy
    */
   slot(asio::io_context& ctx,
        manager_client_type client,
        std::string_view name,
        std::string_view description,
-       tfc::stx::invocable<value_t> auto&& callback)
+       tfc::stx::invocable<value_t> auto&& callback,
+       details::receive_policy_e policy = details::receive_policy_e::all)
     requires std::is_lvalue_reference_v<manager_client_type>
       : slot_{ details::slot_callback<type_desc>::create(
             ctx,
             name,
-            [this, callb = std::forward<decltype(callback)>(callback)](value_t const& new_value) {
-              callb(new_value);
-              dbus_slot_.emit_value(new_value);
-            }) },
-        dbus_slot_{ client.connection(), [this] -> std::optional<value_t> const& { return this->value(); } },
+            emitting(std::forward<decltype(callback)>(callback)),
+            policy) },
+        dbus_slot_{ client.connection(), [this] -> details::receive_statistics const& { return this->statistics(); } },
         client_{ client } {
     client_init(description);
   }
@@ -76,16 +82,16 @@ public:
        std::shared_ptr<sdbusplus::asio::connection> connection,
        std::string_view name,
        std::string_view description,
-       tfc::stx::invocable<value_t> auto&& callback)
+       tfc::stx::invocable<value_t> auto&& callback,
+       details::receive_policy_e policy = details::receive_policy_e::all)
     requires(!std::is_lvalue_reference_v<manager_client_type>)
       : slot_{ details::slot_callback<type_desc>::create(
             ctx,
             name,
-            [this, callb = std::forward<decltype(callback)>(callback)](value_t const& new_value) {
-              callb(new_value);
-              dbus_slot_.emit_value(new_value);
-            }) },
-        dbus_slot_{ connection, [this] -> std::optional<value_t> const& { return this->value(); } }, client_{ connection } {
+            emitting(std::forward<decltype(callback)>(callback)),
+            policy) },
+        dbus_slot_{ connection, [this] -> details::receive_statistics const& { return this->statistics(); } },
+        client_{ connection } {
     client_init(description);
   }
 
@@ -95,6 +101,26 @@ public:
        tfc::stx::invocable<value_t> auto&& callback)
       : slot(ctx, client, name, "", std::forward<decltype(callback)>(callback)) {}
 
+  /**
+   * C'tor for a tfc IPC slot used from an io_context run by several threads.
+   * @param strand the slot receives, filters and invokes callback on
+   */
+  slot(details::strand_t const& strand,
+       manager_client_type client,
+       std::string_view name,
+       std::string_view description,
+       tfc::stx::invocable<value_t> auto&& callback,
+       details::receive_policy_e policy = details::receive_policy_e::all)
+    requires std::is_lvalue_reference_v<manager_client_type>
+      : slot_{ details::slot_callback<type_desc>::create(strand,
+                                                         name,
+                                                         emitting(std::forward<decltype(callback)>(callback)),
+                                                         policy) },
+        dbus_slot_{ client.connection(), [this] -> details::receive_statistics const& { return this->statistics(); } },
+        client_{ client } {
+    client_init(description);
+  }
+
   slot(slot&) = delete;
 
   slot(slot&&) noexcept = delete;
@@ -105,14 +131,50 @@ public:
 
   [[nodiscard]] auto value() const noexcept -> std::optional<value_t> const& { return slot_->value(); }
 
+  /// \return end to end latency and loss of the values received, also exposed on dbus
+  [[nodiscard]] auto statistics() const noexcept -> details::receive_statistics const& { return slot_->statistics(); }
+
   [[nodiscard]] auto name() const noexcept -> std::string_view { return slot_->name(); }
 
   [[nodiscard]] auto full_name() const noexcept -> std::string { return slot_->name_w_type(); }
 
+  /// \return the strand of the slot, or the executor of its io_context if it is single threaded
+  [[nodiscard]] auto executor() const -> asio::any_io_executor { return slot_->executor(); }
+
+  /// \brief limit the property changes emitted on dbus for the values received, every value is emitted by default
+  /// \note call on the executor of the slot
+  void set_emit_policy(details::emit_policy policy) { dbus_slot_.set_emit_policy(policy, slot_->executor()); }
+
+  using history_t = typename details::dbus_slot<value_t>::history_t;
+
+  /// \brief keep the latest capacity values received with their time, queried here or by the History dbus method
+  /// \note call on the executor of the slot
+  void enable_history(std::size_t capacity) { dbus_slot_.enable_history(capacity); }
+
+  /// \return values received in [from, to], at most max_points of them with extremes kept, zero for all of them
+  [[nodiscard]] auto history(typename history_t::time_point from,
+                             typename history_t::time_point to,
+                             std::size_t max_points = 0) const -> typename history_t::samples {
+    return dbus_slot_.history(from, to, max_points);
+  }
+
 private:
+  /// \return callback which also emits the value on dbus
+  auto emitting(auto&& callback) {
+    return [this, callb = std::forward<decltype(callback)>(callback)](value_t const& new_value) {
+      callb(new_value);
+      dbus_slot_.emit_value(new_value);
+    };
+  }
+
   void client_init(std::string_view description) {
+    // The connection change arrives on the thread of the dbus connection, the slot is connected on its own executor
     client_.register_connection_change_callback(slot_->name_w_type(), [this](std::string_view signal_name) {
-      slot_->connect(signal_name);  //
+      asio::dispatch(slot_->executor(), [weak_slot = std::weak_ptr{ slot_ }, name = std::string{ signal_name }] {
+        if (auto instance = weak_slot.lock()) {
+          instance->connect(name);
+        }
+      });
     });
     client_.register_slot(slot_->name_w_type(), description, type_desc::value_e, details::register_cb(slot_->name_w_type()));
 
@@ -127,6 +189,7 @@ private:
 /**
  * an ipc component, registers its existence with an
  * ipc-ruler service.
+ * Thread safety: constructed from a strand, async_send may be called from any thread, see details::signal.
  * @tparam type_desc The type of the signal
  */
 template <typename type_desc, typename manager_client_type>
@@ -140,20 +203,31 @@ public:
    * Signal c'tor
    * @param ctx Execution context
    * @param name Signals name
+   * @param transport opt in to shared memory for slots on the same host, zmq is always available
    */
-  signal(asio::io_context& ctx, manager_client_type& client, std::string_view name, std::string_view description = "")
-      : client_(client) {
-    auto exp{ details::signal<type_desc>::create(ctx, name) };
-    if (!exp.has_value()) {
-      throw std::runtime_error{ fmt::format("Unable to bind to socket, reason: {}", exp.error().message()) };
-    }
-    signal_ = std::move(exp.value());
-    client_.register_signal(signal_->name_w_type(), description, type_desc::value_e,
-                            details::register_cb(signal_->name_w_type()));
-  }
+  signal(asio::io_context& ctx,
+         manager_client_type& client,
+         std::string_view name,
+         std::string_view description = "",
+         details::transport_e transport = details::transport_e::zmq)
+      : signal(client, description, details::signal<type_desc>::create(ctx, name, transport)) {}
+
+  /**
+   * Signal c'tor for a signal published to from several threads
+   * @param strand the signal runs its handlers on
+   */
+  signal(details::strand_t const& strand,
+         manager_client_type& client,
+         std::string_view name,
+         std::string_view description = "",
+         details::transport_e transport = details::transport_e::zmq)
+      : signal(client, description, details::signal<type_desc>::create(strand, name, transport)) {}
 
   auto send(value_t const& value) -> std::error_code { return signal_->send(value); }
 
+  /// \brief append a crc32 of the value to each message, slots reject and count values which do not match
+  void enable_crc(bool enable) noexcept { signal_->enable_crc(enable); }
+
   template <typename completion_token_t>
   auto async_send(value_t const& value, completion_token_t&& token) -> auto {
     return signal_->async_send(value, std::forward<completion_token_t>(token));
@@ -163,7 +237,22 @@ public:
 
   [[nodiscard]] auto full_name() const noexcept -> std::string { return signal_->name_w_type(); }
 
+  /// \return the strand of the signal, or the executor of its io_context if it is single threaded
+  [[nodiscard]] auto executor() const -> asio::any_io_executor { return signal_->executor(); }
+
 private:
+  signal(manager_client_type& client,
+         std::string_view description,
+         std::expected<std::shared_ptr<details::signal<type_desc>>, std::error_code>&& exp)
+      : client_(client) {
+    if (!exp.has_value()) {
+      throw std::runtime_error{ fmt::format("Unable to bind to socket, reason: {}", exp.error().message()) };
+    }
+    signal_ = std::move(exp.value());
+    client_.register_signal(signal_->name_w_type(), description, type_desc::value_e,
+                            details::register_cb(signal_->name_w_type()));
+  }
+
   manager_client_type& client_;
   std::shared_ptr<details::signal<type_desc>> signal_;
 };
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+namespace tfc::ipc {
+
+namespace asio = boost::asio;
+
+/**
+ * @brief
+ * Opt in scope which coalesces signal updates made while it is open on the current thread, nothing opens one by default.
+ * Signals which are async_send'ed within the scope are published once, with their latest value, when the outermost
+ * scope closes. Their completion handlers are invoked after that flush, so a device updating many signals per cycle
+ * results in one message per changed signal and no per send completion handler round trip.
+ * @note intermediate values sent to the same signal within one scope are dropped, slots never see them. Their sends
+ * complete with std::errc::operation_canceled, only the last send to each signal reports the result of publishing.
+ * Only open a batch around code where the latest value of each signal is all that matters.
+ * @example
+ * {
+ *   tfc::ipc::batch const scope{ ctx };
+ *   for (auto& device : devices) device.process_data(); // calls async_send on its signals
+ * } // all updated signals are published here
+ */
+class batch {
+public:
+  using flush_fn = void (*)(void*);
+
+  explicit batch(asio::io_context& ctx) : flushed_{ ctx }, outer_{ current_ == nullptr } {
+    flushed_.expires_at(asio::steady_timer::time_point::max());
+    if (outer_) {
+      current_ = this;
+    }
+  }
+
+  batch(batch const&) = delete;
+  batch(batch&&) = delete;
+  auto operator=(batch const&) -> batch& = delete;
+  auto operator=(batch&&) -> batch& = delete;
+
+  ~batch() {
+    if (!outer_) {
+      return;
+    }
+    current_ = nullptr;
+    flush();
+  }
+
+  /// \return the outermost batch open on this thread, nullptr if none
+  [[nodiscard]] static auto current() noexcept -> batch* { return current_; }
+
+  /// \brief queue the member to be flushed when the scope closes
+  /// \param owner lifetime of the member, members which have expired are not flushed
+  /// \param flush invoked with owner's pointer
+  /// \note the caller is responsible for enqueuing each member only once per batch
+  void enqueue(std::weak_ptr<void> owner, flush_fn flush) { pending_.emplace_back(std::move(owner), flush); }
+
+  /// \brief timer which is cancelled when the batch has been flushed, wait on it to complete after the flush
+  [[nodiscard]] auto flushed() noexcept -> asio::steady_timer& { return flushed_; }
+
+private:
+  void flush() {
+    for (auto& [owner, flush] : pending_) {
+      if (auto instance = owner.lock()) {
+        flush(instance.get());
+      }
+    }
+    pending_.clear();
+    flushed_.cancel();
+  }
+
+  struct entry {
+    entry(std::weak_ptr<void>&& own, flush_fn func) : owner{ std::move(own) }, flush{ func } {}
+    std::weak_ptr<void> owner;
+    flush_fn flush;
+  };
+
+  // Entries are kept per thread so the capacity is reused from one scope to the next
+  static inline thread_local std::vector<entry> pending_{};
+  static inline thread_local batch* current_{ nullptr };
+  asio::steady_timer flushed_;
+  bool outer_;
+};
+
+}  // namespace tfc::ipc
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <tfc/ipc/enums.hpp>
+
+namespace tfc::ipc_ruler {
+
+/// \brief hash of std::string usable with std::string_view keys, lookups do not build a std::string
+struct string_hash {
+  using is_transparent = void;
+  auto operator()(std::string_view key) const noexcept -> std::size_t { return std::hash<std::string_view>{}(key); }
+};
+
+/**
+ * @brief
+ * In memory index of the signals and slots of the ipc ruler and how they are connected.
+ * Holds the slots connected to each signal and the signals and slots of each type, so looking up a name is O(1), the
+ * slots of a signal O(1) and a connection change O(degree of the signal) without allocating, once the lists of the
+ * signal have grown. Names are looked up by std::string_view.
+ * The index is kept along the signal and slot storages, which stay the source of truth, see rebuild().
+ */
+class connection_index {
+public:
+  using type_e = ipc::details::type_e;
+
+  /// \brief add a signal, or change the type of a signal
+  void add_signal(std::string_view name, type_e type) {
+    auto& [key, node]{ signal_entry(name) };
+    if (node.type == type) {
+      return;
+    }
+    if (node.type.has_value()) {
+      erase_value(signals_by_type_[index_of(node.type.value())], key);
+    }
+    node.type = type;
+    signals_by_type_[index_of(type)].emplace_back(key);
+  }
+
+  /// \brief add a slot, or change the type or the connection of a slot
+  /// \param connected_to empty if not connected
+  void add_slot(std::string_view name, type_e type, std::string_view connected_to) {
+    auto iter{ slots_.find(name) };
+    if (iter == slots_.end()) {
+      iter = slots_.emplace(std::string{ name }, slot_node{ .type = type }).first;
+      slots_by_type_[index_of(type)].emplace_back(iter->first);
+    } else if (iter->second.type != type) {
+      erase_value(slots_by_type_[index_of(iter->second.type)], iter->first);
+      iter->second.type = type;
+      slots_by_type_[index_of(type)].emplace_back(iter->first);
+    }
+    link(*iter, connected_to);
+  }
+
+  /// \brief connect a slot to a signal, disconnecting it from its former signal
+  /// \pre the slot has been added
+  void connect(std::string_view slot_name, std::string_view signal_name) {
+    if (auto iter{ slots_.find(slot_name) }; iter != slots_.end()) {
+      link(*iter, signal_name);
+    }
+  }
+
+  /// \pre the slot has been added
+  void disconnect(std::string_view slot_name) { connect(slot_name, {}); }
+
+  /// \return type of the signal, nullopt if it has not been added
+  [[nodiscard]] auto signal_type(std::string_view name) const -> std::optional<type_e> {
+    auto const iter{ signals_.find(name) };
+    return iter == signals_.end() ? std::nullopt : iter->second.type;
+  }
+
+  /// \return type of the slot, nullopt if it has not been added
+  [[nodiscard]] auto slot_type(std::string_view name) const -> std::optional<type_e> {
+    auto const iter{ slots_.find(name) };
+    return iter == slots_.end() ? std::nullopt : std::optional{ iter->second.type };
+  }
+
+  /// \return signal the slot is connected to, empty if none
+  [[nodiscard]] auto connected_to(std::string_view slot_name) const -> std::string_view {
+    auto const iter{ slots_.find(slot_name) };
+    return iter == slots_.end() ? std::string_view{} : std::string_view{ iter->second.connected_to };
+  }
+
+  /// \return slots connected to the signal, in no particular order
+  [[nodiscard]] auto slots_of(std::string_view signal_name) const -> std::span<std::string_view const> {
+    auto const iter{ signals_.find(signal_name) };
+    return iter == signals_.end() ? std::span<std::string_view const>{} : std::span{ iter->second.slots };
+  }
+
+  /// \return signals of the type, those a slot of the type can be connected to
+  [[nodiscard]] auto signals_of_type(type_e type) const -> std::span<std::string_view const> {
+    return signals_by_type_[index_of(type)];
+  }
+
+  [[nodiscard]] auto slots_of_type(type_e type) const -> std::span<std::string_view const> {
+    return slots_by_type_[index_of(type)];
+  }
+
+  /// \brief invoke visitor with each signal, registered or having slots connected, and its slots
+  void for_each_connection(std::invocable<std::string_view, std::span<std::string_view const>> auto&& visitor) const {
+    for (auto const& [name, node] : signals_) {
+      if (node.type.has_value() || !node.slots.empty()) {
+        std::invoke(visitor, std::string_view{ name }, std::span<std::string_view const>{ node.slots });
+      }
+    }
+  }
+
+  /// \brief index the signals and slots of the storages again, when they have been changed elsewhere
+  /// \param signals map of name to tfc::ipc_ruler::signal
+  /// \param slots map of name to tfc::ipc_ruler::slot
+  void rebuild(auto const& signals, auto const& slots) {
+    signals_.clear();
+    slots_.clear();
+    std::ranges::for_each(signals_by_type_, [](auto& names) { names.clear(); });
+    std::ranges::for_each(slots_by_type_, [](auto& names) { names.clear(); });
+    for (auto const& [name, entry] : signals) {
+      add_signal(name, entry.type);
+    }
+    for (auto const& [name, entry] : slots) {
+      add_slot(name, entry.type, entry.connected_to);
+    }
+  }
+
+private:
+  struct signal_node {
+    std::optional<type_e> type{};  // nullopt for a signal which slots are connected to, but is not registered
+    std::vector<std::string_view> slots{};
+  };
+  struct slot_node {
+    type_e type{};
+    std::string connected_to{};
+  };
+  // Keys of unordered_map nodes are stable, the lists refer to them by std::string_view
+  using signal_map = std::unordered_map<std::string, signal_node, string_hash, std::equal_to<>>;
+  using slot_map = std::unordered_map<std::string, slot_node, string_hash, std::equal_to<>>;
+  using by_type = std::array<std::vector<std::string_view>, ipc::details::type_e_iterable.size()>;
+
+  static auto index_of(type_e type) noexcept -> std::size_t {
+    return std::min<std::size_t>(std::to_underlying(type), ipc::details::type_e_iterable.size() - 1);
+  }
+
+  static void erase_value(std::vector<std::string_view>& names, std::string_view name) {
+    if (auto const iter{ std::ranges::find(names, name) }; iter != names.end()) {
+      *iter = names.back();
+      names.pop_back();
+    }
+  }
+
+  auto signal_entry(std::string_view name) -> signal_map::value_type& {
+    auto iter{ signals_.find(name) };
+    if (iter == signals_.end()) {
+      iter = signals_.emplace(std::string{ name }, signal_node{}).first;
+    }
+    return *iter;
+  }
+
+  void link(slot_map::value_type& slot, std::string_view signal_name) {
+    auto& [slot_name, node]{ slot };
+    if (node.connected_to == signal_name) {
+      return;
+    }
+    if (!node.connected_to.empty()) {
+      erase_value(signals_.find(node.connected_to)->second.slots, slot_name);
+    }
+    node.connected_to = signal_name;
+    if (!signal_name.empty()) {
+      signal_entry(signal_name).second.slots.emplace_back(slot_name);
+    }
+  }
+
+  signal_map signals_{};
+  slot_map slots_{};
+  by_type signals_by_type_{};
+  by_type slots_by_type_{};
+};
+
+}  // namespace tfc::ipc_ruler
@@ -1,15 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include <tfc/dbus/sdbusplus_fwd.hpp>
 #include <tfc/ipc/details/dbus_constants.hpp>
 #include <tfc/ipc/details/dbus_structs.hpp>
+#include <tfc/ipc/details/directory.hpp>
 #include <tfc/ipc/enums.hpp>
 #include <tfc/utils/asio_fwd.hpp>
 
@@ -33,6 +36,7 @@ public:
 
   /**
    * Register a signal with the ipc_manager service running on dbus
+   * Registrations made within one io_context tick are sent together in one RegisterMany call
    * @param name the name of the signal to be registered
    * @param type  the type enum of the signal to be registered
    * @param handler  the error handling callback function
@@ -44,6 +48,7 @@ public:
 
   /**
    * Register a slot with the ipc_manager service running on dbus
+   * Registrations made within one io_context tick are sent together in one RegisterMany call
    * @param name the name of the slot to be registered
    * @param type  the type enum of the slot to be registered
    * @param handler  the error handling callback function
@@ -69,6 +74,15 @@ public:
    */
   auto slots(std::function<void(std::vector<slot> const&)>&& handler) -> void;
 
+  /**
+   * Local copy of the signals and slots of the ipc manager, read in full on the first call and kept up to date from the
+   * changes the ipc manager emits, which are only matched from the first call on. It is read in full again when a change
+   * has been missed.
+   * Prefer it over signals() and slots() when looking up entries or following them as they are added.
+   * @return the directory, empty until the first read has completed, see directory::synchronized()
+   */
+  auto directory() -> ipc_ruler::directory&;
+
   /**
    * Async function to get the connections from the ipc manager.
    * @param handler  a function like object that is called with a map og strings and a vector of strings
@@ -116,9 +130,30 @@ public:
       -> std::unique_ptr<sdbusplus::bus::match::match>;
 
 private:
+  /// \brief registrations waiting for the RegisterMany call posted by the first of them
+  struct registration_batch {
+    std::vector<registration_t> signals{};
+    std::vector<registration_t> slots{};
+    std::vector<std::function<void(std::error_code const&)>> handlers{};
+    bool flush_posted{ false };
+  };
+
+  /// \brief directory and the state of reading it, shared with the dbus call in flight
+  struct directory_state {
+    ipc_ruler::directory directory{};
+    bool subscribed{ false };
+    bool synchronizing{ false };
+  };
+
+  auto enqueue_registration(std::vector<registration_t> registration_batch::*list,
+                            registration_t registration,
+                            std::function<void(std::error_code const&)>&& handler) -> void;
   auto make_match(const std::string& match_rule, std::function<void(sdbusplus::message_t&)> const& callback)
       -> std::unique_ptr<sdbusplus::bus::match::match>;
   auto match_callback(sdbusplus::message_t& msg) -> void;
+  auto directory_change(sdbusplus::message_t& msg) -> void;
+  auto make_directory_matches() -> void;
+  auto synchronize_directory() -> void;
   const std::string ipc_ruler_service_name_{ consts::ipc_ruler_service_name };
   const std::string ipc_ruler_interface_name_{ consts::ipc_ruler_interface_name };
   const std::string ipc_ruler_object_path_{ consts::ipc_ruler_object_path };
@@ -127,6 +162,12 @@ private:
   std::shared_ptr<sdbusplus::asio::connection> connection_;
   std::unique_ptr<sdbusplus::bus::match::match, std::function<void(sdbusplus::bus::match::match*)>> connection_match_;
   std::unordered_map<std::string, std::function<void(std::string_view const)>> slot_callbacks_;
+  // shared with the posted flush, which may run after the client has been moved from
+  std::shared_ptr<registration_batch> registrations_{ std::make_shared<registration_batch>() };
+  std::shared_ptr<directory_state> directory_{ std::make_shared<directory_state>() };
+  // the changes to the lists, matched once the directory is first used
+  std::vector<std::unique_ptr<sdbusplus::bus::match::match, std::function<void(sdbusplus::bus::match::match*)>>>
+      directory_matches_{};
 };
 
 }  // namespace tfc::ipc_ruler
@@ -13,6 +13,7 @@
 
 #include <tfc/dbus/sdbusplus_fwd.hpp>
 #include <tfc/ipc/details/dbus_structs.hpp>
+#include <tfc/ipc/details/directory.hpp>
 #include <tfc/ipc/enums.hpp>
 #include <tfc/stx/concepts.hpp>
 #include <tfc/utils/asio_fwd.hpp>
@@ -56,6 +57,11 @@ struct ipc_manager_client_mock {
     for (auto& slot : slots_) {
       if (slot.name == slot_name) {
         slot.connected_to = signal_name;
+        if (directory_.synchronized()) {
+          [[maybe_unused]] auto const applied{
+            directory_.apply_connection(directory_.generation() + 1, slot_name, signal_name)
+          };
+        }
         auto iterator = slot_callbacks.find(slot_name);
         if (iterator != slot_callbacks.end()) {
           std::invoke(iterator->second, signal_name);
@@ -72,6 +78,9 @@ struct ipc_manager_client_mock {
 
   auto signals(tfc::stx::invocable<const std::vector<signal>&> auto&& handler) -> void { handler(signals_); }
 
+  /// \brief directory of the registered signals and slots, filled on the first call and updated by later registrations
+  auto directory() -> ipc_ruler::directory&;
+
   auto register_properties_change_callback(std::function<void(sdbusplus::message_t&)> const&)
       -> std::unique_ptr<sdbusplus::bus::match::match>;
 
@@ -80,6 +89,7 @@ struct ipc_manager_client_mock {
   std::vector<std::function<void(sdbusplus::message_t&)>> callbacks_ = {};
   std::unordered_map<std::string, std::function<void(std::string_view const)>> slot_callbacks;
   std::shared_ptr<sdbusplus::asio::connection> conn_{};
+  ipc_ruler::directory directory_{};
 };
 
 }  // namespace tfc::ipc_ruler
@@ -12,10 +12,18 @@ static constexpr std::string_view signals_property{ "Signals" };
 static constexpr std::string_view slots_property{ "Slots" };
 static constexpr std::string_view register_signal{ "RegisterSignal" };
 static constexpr std::string_view register_slot{ "RegisterSlot" };
+static constexpr std::string_view register_many{ "RegisterMany" };
 static constexpr std::string_view disconnect_method{ "Disconnect" };
 static constexpr std::string_view connect_method{ "Connect" };
 static constexpr std::string_view connections_property{ "Connections" };
 static constexpr std::string_view connection_change{ "ConnectionChange" };
+// Changes to the lists above, each carries the generation it brings the lists to
+static constexpr std::string_view generation_property{ "Generation" };
+static constexpr std::string_view signal_added{ "SignalAdded" };
+static constexpr std::string_view slot_added{ "SlotAdded" };
+static constexpr std::string_view connection_changed{ "ConnectionChanged" };
+// The lists have been reloaded from disk, carries the generation they are at and clients read them again
+static constexpr std::string_view directory_reset{ "DirectoryReset" };
 
 // service name
 static constexpr auto ipc_ruler_service_name = dbus::const_dbus_name<dbus_name>;
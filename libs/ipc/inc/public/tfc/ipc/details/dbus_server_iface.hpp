@@ -3,7 +3,11 @@
 // ipc-ruler.cpp - Dbus API service maintaining a list of signals/slots and which signal
 // is connected to which slot
 
+#include <cstdint>
 #include <functional>
+#include <span>
+#include <string_view>
+#include <tuple>
 #include <utility>
 
 #include <fmt/chrono.h>
@@ -18,6 +22,7 @@
 #include <tfc/dbus/match_rules.hpp>
 #include <tfc/dbus/sd_bus.hpp>
 #include <tfc/dbus/string_maker.hpp>
+#include <tfc/ipc/details/connection_index.hpp>
 #include <tfc/ipc/details/dbus_constants.hpp>
 #include <tfc/ipc/details/dbus_structs.hpp>
 #include <tfc/ipc/details/dbus_structs_glaze_meta.hpp>
@@ -41,57 +46,65 @@ public:
   using signal_name = std::string_view;
 
   explicit ipc_manager(signal_storage& signals, slot_storage& slots)
-      : logger_("ipc_manager"), signals_{ signals }, slots_{ slots } {}
+      : logger_("ipc_manager"), signals_{ signals }, slots_{ slots } {
+    index_.rebuild(signals_.value(), slots_.value());
+    // The files may be edited while running
+    if constexpr (requires { signals_.on_change([] {}); }) {
+      signals_.on_change([this] { reload(); });
+    }
+    if constexpr (requires { slots_.on_change([] {}); }) {
+      slots_.on_change([this] { reload(); });
+    }
+  }
 
   auto set_callback(std::function<void(slot_name, signal_name)> on_connect_cb) -> void {
     on_connect_cb_ = std::move(on_connect_cb);
   }
 
-  auto register_signal(const std::string_view name, const std::string_view description, type_e type) -> void {
+  /// \brief callback invoked once the signals or slots have been reloaded after the files were edited
+  auto set_reload_callback(std::function<void()> on_reload_cb) -> void { on_reload_cb_ = std::move(on_reload_cb); }
+
+  /// \return the signal as registered
+  auto register_signal(const std::string_view name, const std::string_view description, type_e type) -> signal const& {
     logger_.trace("register_signal called name: {}, type: {}", name, enum_name(type));
-    auto timestamp_now = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
-    auto str_name = std::string(name);
     auto change_signals = signals_.make_change();
-    if (signals_->find(str_name) != signals_->end()) {
-      auto it = change_signals->find(str_name);
-      it->second.last_registered = timestamp_now;
-      it->second.description = std::string(description);
-      it->second.type = type;
-    } else {
-      change_signals->emplace(name, signal{ .name = std::string(name),
-                                            .type = type,
-                                            .created_by = "",
-                                            .created_at = timestamp_now,
-                                            .last_registered = timestamp_now,
-                                            .description = std::string(description) });
-    }
+    return upsert_signal(change_signals, name, description, type, now());
   }
 
-  auto register_slot(const std::string_view name, const std::string_view description, type_e type) -> void {
+  /// \return the slot as registered
+  auto register_slot(const std::string_view name, const std::string_view description, type_e type) -> slot const& {
     logger_.trace("register_slot called name: {}, type: {}", name, enum_name(type));
-    auto timestamp_now = std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
-    auto timestamp_never = std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds>{};
-
-    auto str_name = std::string(name);
     auto change_slots = slots_.make_change();
-    if (change_slots->find(str_name) != slots_->end()) {
-      auto it = change_slots->find(str_name);
-      it->second.last_registered = timestamp_now;
-      it->second.description = std::string(description);
-      it->second.type = type;
-    } else {
-      change_slots->emplace(name, slot{ .name = std::string(name),
-                                        .type = type,
-                                        .created_by = "omar",
-                                        .created_at = timestamp_now,
-                                        .last_registered = timestamp_now,
-                                        .last_modified = timestamp_never,
-                                        .modified_by = "",
-                                        .connected_to = "",
-                                        .description = std::string(description) });
+    return upsert_slot(change_slots, name, description, type, now());
+  }
+
+  /**
+   * Register signals and slots writing each storage once, instead of once for every signal and slot.
+   * Signals are registered before slots, a slot may be connected to a signal of the same batch.
+   * \return the signals and slots as registered
+   */
+  auto register_many(std::span<registration_t const> new_signals, std::span<registration_t const> new_slots)
+      -> std::pair<std::vector<signal>, std::vector<slot>> {
+    logger_.trace("register_many called signals: {}, slots: {}", new_signals.size(), new_slots.size());
+    auto const timestamp_now{ now() };
+    std::pair<std::vector<signal>, std::vector<slot>> registered{};
+    if (!new_signals.empty()) {
+      registered.first.reserve(new_signals.size());
+      auto change_signals = signals_.make_change();
+      for (auto const& [name, description, type] : new_signals) {
+        registered.first.emplace_back(
+            upsert_signal(change_signals, name, description, static_cast<type_e>(type), timestamp_now));
+      }
     }
-    // Call the connected callback to get the slot connected to its signal if it has one.
-    on_connect_cb_(str_name, change_slots->at(str_name).connected_to);
+    if (!new_slots.empty()) {
+      registered.second.reserve(new_slots.size());
+      auto change_slots = slots_.make_change();
+      for (auto const& [name, description, type] : new_slots) {
+        registered.second.emplace_back(
+            upsert_slot(change_slots, name, description, static_cast<type_e>(type), timestamp_now));
+      }
+    }
+    return registered;
   }
 
   auto get_all_signals() -> std::vector<signal> {
@@ -113,55 +126,133 @@ public:
 
   auto get_all_connections() -> std::map<std::string, std::vector<std::string>> {
     std::map<std::string, std::vector<std::string>> connections;
-    std::for_each(signals_->begin(), signals_->end(),
-                  [&](const std::pair<std::string, signal>& key_value) { connections[key_value.second.name] = {}; });
-    std::for_each(slots_->begin(), slots_->end(), [&](const std::pair<std::string, slot>& slot) {
-      if (!slot.second.connected_to.empty()) {
-        connections[slot.second.connected_to].emplace_back(slot.second.name);
-      }
+    index_.for_each_connection([&connections](std::string_view signal_name, std::span<std::string_view const> slot_names) {
+      connections.emplace(signal_name, std::vector<std::string>{ slot_names.begin(), slot_names.end() });
     });
     return connections;
   }
 
+  /// \brief index of the connections and types, kept up to date with the storages
+  [[nodiscard]] auto index() const noexcept -> connection_index const& { return index_; }
+
   auto connect(const std::string_view slot_name, const std::string_view signal_name) -> void {
-    auto str_slot_name = std::string(slot_name);
-    auto str_signal_name = std::string(signal_name);
     logger_.trace("connect called, slot: {}, signal: {}", slot_name, signal_name);
-    if (slots_->find(str_slot_name) == slots_->end()) {
+    auto const slot_type{ index_.slot_type(slot_name) };
+    if (!slot_type.has_value()) {
       std::string const err_msg = fmt::format("Slot ({}) does not exist", slot_name);
       logger_.warn(err_msg);
       throw dbus_error(err_msg);
     }
-    if (signals_->find(str_signal_name) == signals_->end()) {
+    auto const signal_type{ index_.signal_type(signal_name) };
+    if (!signal_type.has_value()) {
       std::string const err_msg = fmt::format("Signal ({}) does not exist", signal_name);
       logger_.warn(err_msg);
       throw dbus_error(err_msg);
     }
-    if (slots_->at(str_slot_name).type != signals_->at(str_signal_name).type) {
+    if (slot_type != signal_type) {
       std::string const err_msg = "Signal and slot types dont match";
       logger_.warn(err_msg);
       throw dbus_error(err_msg);
     }
 
-    slots_.make_change()->at(str_slot_name).connected_to = signal_name;
+    set_connected_to(slot_name, signal_name);
     on_connect_cb_(slot_name, signal_name);
   }
 
   auto disconnect(const std::string_view slot_name) -> void {
     logger_.trace("disconnect called, slot: {}", slot_name);
-    const std::string str_slot_name = std::string(slot_name);
-    if (slots_->find(str_slot_name) == slots_->end()) {
+    if (!index_.slot_type(slot_name).has_value()) {
       throw std::runtime_error("Slot does not exist");
     }
-    slots_.make_change()->at(str_slot_name).connected_to = "";
+    set_connected_to(slot_name, "");
     on_connect_cb_(slot_name, "");
   }
 
 private:
+  static auto now() -> time_point_t {
+    return std::chrono::time_point_cast<std::chrono::milliseconds>(std::chrono::system_clock::now());
+  }
+
+  /// \return iterator to the entry of name, without building a std::string if the storage supports string_view lookup
+  static auto find(auto& storage, std::string_view name) {
+    if constexpr (requires { storage.find(name); }) {
+      return storage.find(name);
+    } else {
+      return storage.find(std::string{ name });
+    }
+  }
+
+  void set_connected_to(std::string_view slot_name, std::string_view signal_name) {
+    auto change_slots = slots_.make_change();
+    if (auto it = find(change_slots.value(), slot_name); it != change_slots->end()) {
+      it->second.connected_to = signal_name;
+    }
+    index_.connect(slot_name, signal_name);
+  }
+
+  auto upsert_signal(auto& change_signals,
+                     const std::string_view name,
+                     const std::string_view description,
+                     type_e type,
+                     time_point_t timestamp_now) -> signal const& {
+    index_.add_signal(name, type);
+    if (auto it = find(change_signals.value(), name); it != change_signals->end()) {
+      it->second.last_registered = timestamp_now;
+      it->second.description = std::string(description);
+      it->second.type = type;
+      return it->second;
+    }
+    return change_signals->emplace(name, signal{ .name = std::string(name),
+                                                 .type = type,
+                                                 .created_by = "",
+                                                 .created_at = timestamp_now,
+                                                 .last_registered = timestamp_now,
+                                                 .description = std::string(description) })
+        .first->second;
+  }
+
+  auto upsert_slot(auto& change_slots,
+                   const std::string_view name,
+                   const std::string_view description,
+                   type_e type,
+                   time_point_t timestamp_now) -> slot const& {
+    auto timestamp_never = time_point_t{};
+    auto it = find(change_slots.value(), name);
+    if (it != change_slots->end()) {
+      it->second.last_registered = timestamp_now;
+      it->second.description = std::string(description);
+      it->second.type = type;
+    } else {
+      it = change_slots->emplace(name, slot{ .name = std::string(name),
+                                             .type = type,
+                                             .created_by = "omar",
+                                             .created_at = timestamp_now,
+                                             .last_registered = timestamp_now,
+                                             .last_modified = timestamp_never,
+                                             .modified_by = "",
+                                             .connected_to = "",
+                                             .description = std::string(description) })
+               .first;
+    }
+    index_.add_slot(name, type, it->second.connected_to);
+    // Call the connected callback to get the slot connected to its signal if it has one.
+    on_connect_cb_(name, it->second.connected_to);
+    return it->second;
+  }
+
+  void reload() {
+    index_.rebuild(signals_.value(), slots_.value());
+    if (on_reload_cb_) {
+      on_reload_cb_();
+    }
+  }
+
   tfc::logger::logger logger_;
   signal_storage& signals_;
   slot_storage& slots_;
   std::function<void(std::string_view, std::string_view)> on_connect_cb_;
+  std::function<void()> on_reload_cb_;
+  connection_index index_{};
 };
 
 template <typename signal_storage, typename slot_storage>
@@ -181,51 +272,105 @@ public:
       message.append(std::tuple<std::string, std::string>(slot_name, signal_name));
       message.signal_send();
     });
+    // No delta describes an edit of the files, clients read the lists again
+    ipc_manager_->set_reload_callback([&] {
+      emit_delta(consts::directory_reset);
+      dbus_interface_->signal_property(std::string(consts::signals_property));
+      dbus_interface_->signal_property(std::string(consts::slots_property));
+      dbus_interface_->signal_property(std::string(consts::connections_property));
+    });
     dbus_interface_->register_method(std::string(consts::connect_method),
                                      [&](const std::string& slot_name, const std::string& signal_name) {
                                        ipc_manager_->connect(slot_name, signal_name);
+                                       emit_delta(consts::connection_changed, slot_name, signal_name);
                                        dbus_interface_->signal_property(std::string(consts::slots_property));
                                        dbus_interface_->signal_property(std::string(consts::connections_property));
                                      });
 
     dbus_interface_->register_method(std::string(consts::disconnect_method), [&](const std::string& slot_name) {
       ipc_manager_->disconnect(slot_name);
+      emit_delta(consts::connection_changed, slot_name, std::string{});
       dbus_interface_->signal_property(std::string(consts::slots_property));
       dbus_interface_->signal_property(std::string(consts::connections_property));
     });
 
     dbus_interface_->register_method(std::string(consts::register_signal),
                                      [&](const std::string& name, const std::string& description, uint8_t type) {
-                                       ipc_manager_->register_signal(name, description, static_cast<type_e>(type));
+                                       auto const& registered{ ipc_manager_->register_signal(name, description,
+                                                                                             static_cast<type_e>(type)) };
+                                       emit_delta(consts::signal_added, glz::write_json(registered));
                                        dbus_interface_->signal_property(std::string(consts::signals_property));
                                      });
+    dbus_interface_->register_method(
+        std::string(consts::register_many),
+        [&](const std::vector<registration_t>& new_signals, const std::vector<registration_t>& new_slots) {
+          auto const [signals, slots]{ ipc_manager_->register_many(new_signals, new_slots) };
+          for (auto const& registered : signals) {
+            emit_delta(consts::signal_added, glz::write_json(registered));
+          }
+          for (auto const& registered : slots) {
+            emit_delta(consts::slot_added, glz::write_json(registered));
+          }
+          if (!signals.empty()) {
+            dbus_interface_->signal_property(std::string(consts::signals_property));
+          }
+          if (!slots.empty()) {
+            dbus_interface_->signal_property(std::string(consts::slots_property));
+          }
+        });
     dbus_interface_->register_method(std::string(consts::register_slot),
                                      [&](const std::string& name, const std::string& description, uint8_t type) {
-                                       ipc_manager_->register_slot(name, description, static_cast<type_e>(type));
+                                       auto const& registered{ ipc_manager_->register_slot(name, description,
+                                                                                           static_cast<type_e>(type)) };
+                                       emit_delta(consts::slot_added, glz::write_json(registered));
                                        dbus_interface_->signal_property(std::string(consts::slots_property));
                                      });
 
+    // The lists are only serialized when read, a change invalidates them without carrying their value.
+    // Clients follow the SignalAdded, SlotAdded and ConnectionChanged deltas instead.
     dbus_interface_->register_property_r<std::string>(
-        std::string(consts::signals_property), sdbusplus::vtable::property_::emits_change,
+        std::string(consts::signals_property), sdbusplus::vtable::property_::emits_invalidation,
         [&](const auto&) { return glz::write_json(ipc_manager_->get_all_signals()); });
 
     dbus_interface_->register_property_r<std::string>(
-        std::string(consts::slots_property), sdbusplus::vtable::property_::emits_change,
+        std::string(consts::slots_property), sdbusplus::vtable::property_::emits_invalidation,
         [&](const auto&) { return glz::write_json(ipc_manager_->get_all_slots()); });
 
     dbus_interface_->register_property_r<std::string>(
-        std::string(consts::connections_property), sdbusplus::vtable::property_::emits_change,
+        std::string(consts::connections_property), sdbusplus::vtable::property_::emits_invalidation,
         [&](const auto&) { return glz::write_json(ipc_manager_->get_all_connections()); });
 
+    dbus_interface_->register_property_r<std::uint64_t>(std::string(consts::generation_property),
+                                                        sdbusplus::vtable::property_::none,
+                                                        [&](const auto&) { return generation_; });
+
     dbus_interface_->register_signal<std::tuple<std::string, std::string>>("");
+    dbus_interface_->register_signal<std::tuple<std::uint64_t, std::string>>(std::string(consts::signal_added));
+    dbus_interface_->register_signal<std::tuple<std::uint64_t, std::string>>(std::string(consts::slot_added));
+    dbus_interface_->register_signal<std::tuple<std::uint64_t, std::string, std::string>>(
+        std::string(consts::connection_changed));
+    dbus_interface_->register_signal<std::tuple<std::uint64_t>>(std::string(consts::directory_reset));
     dbus_interface_->initialize();
   }
 
 private:
+  /**
+   * Emit a change to the lists, carrying the generation it brings them to.
+   * A client which has applied generation N applies N + 1, on a gap it reads the lists and the Generation property
+   * again in one GetAll call. Deltas are keyed by name, so applying one the lists already include is harmless.
+   */
+  void emit_delta(std::string_view member, auto&&... entry) {
+    generation_++;
+    auto message = dbus_interface_->new_signal(member.data());
+    message.append(std::tuple{ generation_, std::forward<decltype(entry)>(entry)... });
+    message.signal_send();
+  }
+
   std::shared_ptr<sdbusplus::asio::connection> connection_;
   std::unique_ptr<sdbusplus::asio::dbus_interface> dbus_interface_;
   std::unique_ptr<sdbusplus::asio::object_server> object_server_;
   std::unique_ptr<ipc_manager<signal_storage, slot_storage>> ipc_manager_;
+  std::uint64_t generation_{ 0 };
 };
 
 }  // namespace tfc::ipc_ruler
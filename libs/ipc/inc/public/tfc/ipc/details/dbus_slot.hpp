@@ -1,15 +1,29 @@
 #pragma once
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <fmt/format.h>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/dispatch.hpp>
 #include <boost/asio/io_context.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 
 #include <tfc/dbus/string_maker.hpp>
-#include <tfc/ipc/details/dbus_slot.hpp>
+#include <tfc/ipc/details/history.hpp>
+#include <tfc/ipc/details/statistics.hpp>
 #include <tfc/stx/concepts.hpp>
+#include <tfc/stx/small_function.hpp>
+#include <tfc/utils/timing_wheel.hpp>
 
 namespace tfc::ipc::details {
 
@@ -19,47 +33,276 @@ namespace dbus::tags {
 static constexpr std::string_view value{ "Value" };
 static constexpr std::string_view slot{ "Slot" };
 static constexpr std::string_view path{ tfc::dbus::const_dbus_path<slot> };
+static constexpr std::string_view received{ "Received" };
+static constexpr std::string_view dropped{ "Dropped" };
+static constexpr std::string_view gaps{ "Gaps" };
+static constexpr std::string_view conflated{ "Conflated" };
+static constexpr std::string_view errors{ "Errors" };
+static constexpr std::string_view latency_p50{ "LatencyP50" };
+static constexpr std::string_view latency_p99{ "LatencyP99" };
+static constexpr std::string_view latency_p999{ "LatencyP999" };
+static constexpr std::string_view latency_histogram{ "LatencyHistogram" };
+static constexpr std::string_view history{ "History" };
 }  // namespace dbus::tags
 
+enum struct emit_policy_e : std::uint8_t {
+  every = 0,      // every value is emitted as a property change, the default
+  max_rate = 1,   // at most one value per interval, the latest one
+  on_change = 2,  // values differing more than deadband from the last emitted value, at most one per interval
+  on_demand = 3,  // nothing is emitted, the value is read when requested
+};
+
+/// \brief how the values of a slot are emitted on dbus, decoupling the load on the bus from the rate of the signal
+struct emit_policy {
+  emit_policy_e policy{ emit_policy_e::every };
+  std::chrono::milliseconds interval{ 0 };
+  double deadband{ 0.0 };  // only for numeric values
+};
+
+/**
+ * @brief
+ * Exposes the values of a slot on dbus.
+ * Thread safety: emit_value, set_emit_policy and enable_history are called on the executor of the slot. The dbus
+ * property getters and the History method run on the threads of the dbus connection, they read the value as of the
+ * last emit_value and the history under a mutex. The statistics are copied by the first emit_value after they
+ * have been read, so a read returns them as of the first value received after the previous read. sd_bus is not
+ * thread safe, property changes are emitted from the io_context of the connection, which is expected to be run by a
+ * single thread.
+ */
 template <typename slot_value_t>
 class dbus_slot {
 public:
   using value_t = slot_value_t;
+  using history_t = value_history<value_t>;
 
-  explicit dbus_slot(asio::io_context& ctx, auto&& value_getter)
-      : dbus_slot(std::make_shared<sdbusplus::asio::connection>(ctx), std::forward<decltype(value_getter)>(value_getter)) {}
-  explicit dbus_slot(std::shared_ptr<sdbusplus::asio::connection> conn, auto&& value_getter)
-      : conn_{ std::move(conn) }, value_getter_{ std::forward<decltype(value_getter)>(value_getter) } {}
+  explicit dbus_slot(asio::io_context& ctx) : dbus_slot(std::make_shared<sdbusplus::asio::connection>(ctx)) {}
+  explicit dbus_slot(std::shared_ptr<sdbusplus::asio::connection> conn) : conn_{ std::move(conn) } {}
+  /// \param statistics_getter exposes latency and loss of the slot as read only properties, read by the first
+  /// emit_value after they have been read over dbus
+  explicit dbus_slot(std::shared_ptr<sdbusplus::asio::connection> conn, auto&& statistics_getter)
+      : conn_{ std::move(conn) }, statistics_getter_{ std::forward<decltype(statistics_getter)>(statistics_getter) } {}
+  dbus_slot(dbus_slot const&) = delete;
+  auto operator=(dbus_slot const&) -> dbus_slot& = delete;
+  ~dbus_slot() {
+    if (flush_timer_) {
+      tfc::utils::timing_wheel::of(executor_).cancel(flush_timer_);
+    }
+  }
   asio::io_context& io_context() const noexcept { return conn_->get_io_context(); }
   std::shared_ptr<sdbusplus::asio::connection> connection() const noexcept { return conn_; }
   void initialize(std::string_view slot_name) {
     if (!conn_) {
       return;
     }
-    interface_ = std::make_unique<sdbusplus::asio::dbus_interface>(
+    interface_ = std::make_shared<sdbusplus::asio::dbus_interface>(
         conn_, std::string{ dbus::tags::path },
         tfc::dbus::make_dbus_name(fmt::format("{}.{}", slot_name, dbus::tags::value)));
     interface_->register_property_r<value_t>(std::string{ dbus::tags::value }, sdbusplus::vtable::property_::emits_change,
                                              [this]([[maybe_unused]] value_t& old_value) {
-                                               if (auto current_value = value_getter_(); current_value.has_value()) {
-                                                 return current_value.value();
-                                               }
-                                               return value_t{};
+                                               std::lock_guard const lock{ mutex_ };
+                                               return current_.value_or(value_t{});
                                              });
+    if (statistics_getter_) {
+      register_statistics();
+    }
+    // (from, to, max_points) -> (timestamps, values), times in nanoseconds since epoch, max_points zero for all values
+    interface_->register_method(
+        std::string{ dbus::tags::history },
+        [this](std::int64_t from, std::int64_t to,
+               std::uint64_t max_points) -> std::tuple<std::vector<std::int64_t>, std::vector<value_t>> {
+          using time_point = typename history_t::time_point;
+          auto const time{ [](std::int64_t nanoseconds) {
+            using duration = typename time_point::duration;
+            return time_point{ std::chrono::duration_cast<duration>(std::chrono::nanoseconds{ nanoseconds }) };
+          } };
+          auto samples{ history(time(from), time(to), max_points) };
+          std::vector<std::int64_t> timestamps{};
+          timestamps.reserve(samples.timestamps.size());
+          for (auto const& timestamp : samples.timestamps) {
+            timestamps.emplace_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count());
+          }
+          return { std::move(timestamps), std::move(samples.values) };
+        });
     interface_->initialize();
     conn_->request_name(tfc::dbus::make_dbus_name(fmt::format("{}._slot_", slot_name)).c_str());
   }
 
+  /// \param executor the values are emitted on, the deferred emissions of max_rate and on_change are run on it
+  void set_emit_policy(emit_policy policy, asio::any_io_executor executor) {
+    // the timer is cancelled on the wheel it was scheduled on, the new executor may belong to another io_context
+    bool const held_back{ flush_timer_ && tfc::utils::timing_wheel::of(executor_).cancel(flush_timer_) };
+    executor_ = std::move(executor);
+    policy_ = policy;
+    // a value held back for the former policy is emitted right away, unless nothing is to be emitted anymore
+    if (held_back && policy_.policy != emit_policy_e::on_demand) {
+      flush();
+    }
+    pending_.reset();
+  }
+
+  /// \brief record the latest capacity values with the time they are emitted, queried over dbus by the History method
+  /// \note every value is recorded, regardless of the emit policy
+  void enable_history(std::size_t capacity) {
+    std::lock_guard const lock{ mutex_ };
+    history_.reset(capacity);
+  }
+
+  /// \return values recorded in [from, to], at most max_points of them with extremes kept, zero for all of them
+  [[nodiscard]] auto history(typename history_t::time_point from,
+                             typename history_t::time_point to,
+                             std::size_t max_points = 0) const -> typename history_t::samples {
+    std::lock_guard const lock{ mutex_ };
+    return history_.history(from, to, max_points);
+  }
+
   void emit_value(value_t const& value) {
-    if (interface_) {
-      interface_->set_property(std::string{ dbus::tags::value }, value);
+    {
+      std::lock_guard const lock{ mutex_ };
+      history_.record(history_t::clock::now(), value);
+      current_ = value;
+      if (statistics_getter_ && statistics_read_) {
+        statistics_ = statistics_getter_();
+        statistics_read_ = false;
+      }
+    }
+    if (!interface_) {
+      return;
+    }
+    switch (policy_.policy) {
+      case emit_policy_e::every:
+        set_value(value);
+        return;
+      case emit_policy_e::on_demand:
+        return;
+      case emit_policy_e::on_change:
+        // while an emission is pending the latest value replaces it, it is compared when it is due
+        if (!flush_timer_ && !changed(value)) {
+          return;
+        }
+        coalesce(value);
+        return;
+      case emit_policy_e::max_rate:
+        coalesce(value);
+        return;
     }
   }
 
 private:
+  using clock = std::chrono::steady_clock;
+
+  /// \return true if value differs more than the deadband from the value last emitted
+  [[nodiscard]] auto changed(value_t const& value) const -> bool {
+    if (!last_emitted_.has_value()) {
+      return true;
+    }
+    if constexpr (std::is_arithmetic_v<value_t> && !std::is_same_v<value_t, bool>) {
+      return std::fabs(static_cast<double>(value) - static_cast<double>(last_emitted_.value())) > policy_.deadband;
+    } else {
+      return value != last_emitted_.value();
+    }
+  }
+
+  /// \brief emit now if the interval has passed since the last emission, otherwise keep the latest value until it has
+  void coalesce(value_t const& value) {
+    if (flush_timer_) {
+      pending_ = value;
+      return;
+    }
+    auto const due{ last_emit_ + policy_.interval };
+    if (clock::now() >= due) {
+      set_value(value);
+      return;
+    }
+    pending_ = value;
+    flush_timer_ = tfc::utils::timing_wheel::of(executor_).schedule_at(
+        due, [this, executor = executor_, alive = std::weak_ptr{ alive_ }](std::error_code const& err) {
+          if (err) {
+            return;  // cancelled by the destructor or a policy change
+          }
+          asio::dispatch(executor, [this, alive] {
+            if (alive.expired()) {
+              return;
+            }
+            flush_timer_ = {};
+            flush();
+          });
+        });
+  }
+
+  void flush() {
+    if (pending_.has_value() && (policy_.policy != emit_policy_e::on_change || changed(pending_.value()))) {
+      set_value(pending_.value());
+    }
+    pending_.reset();
+  }
+
+  void set_value(value_t const& value) {
+    asio::dispatch(conn_->get_io_context(), [interface = std::weak_ptr{ interface_ }, value] {
+      if (auto const locked{ interface.lock() }) {
+        locked->set_property(std::string{ dbus::tags::value }, value);
+      }
+    });
+    if (policy_.policy != emit_policy_e::every) {
+      last_emitted_ = value;
+      last_emit_ = clock::now();
+    }
+  }
+
+  void register_statistics() {
+    auto const counter{ [this](std::string_view name, std::uint64_t receive_statistics::*member) {
+      interface_->register_property_r<std::uint64_t>(
+          std::string{ name }, sdbusplus::vtable::property_::none,
+          [this, member](std::uint64_t const&) -> std::uint64_t {
+            std::lock_guard const lock{ mutex_ };
+            statistics_read_ = true;
+            return statistics_.*member;
+          });
+    } };
+    counter(dbus::tags::received, &receive_statistics::received);
+    counter(dbus::tags::dropped, &receive_statistics::dropped);
+    counter(dbus::tags::gaps, &receive_statistics::gaps);
+    counter(dbus::tags::conflated, &receive_statistics::conflated);
+    counter(dbus::tags::errors, &receive_statistics::errors);
+    // latencies in nanoseconds, the upper bound of the histogram bucket
+    auto const latency{ [this](std::string_view name, double quantile) {
+      interface_->register_property_r<std::uint64_t>(
+          std::string{ name }, sdbusplus::vtable::property_::none, [this, quantile](std::uint64_t const&) -> std::uint64_t {
+            std::lock_guard const lock{ mutex_ };
+            statistics_read_ = true;
+            return static_cast<std::uint64_t>(statistics_.latency.quantile(quantile).count());
+          });
+    } };
+    latency(dbus::tags::latency_p50, 0.5);
+    latency(dbus::tags::latency_p99, 0.99);
+    latency(dbus::tags::latency_p999, 0.999);
+    // bucket i counts latencies in [2^i, 2^(i+1)) nanoseconds
+    interface_->register_property_r<std::vector<std::uint64_t>>(
+        std::string{ dbus::tags::latency_histogram }, sdbusplus::vtable::property_::none,
+        [this](std::vector<std::uint64_t> const&) -> std::vector<std::uint64_t> {
+          std::lock_guard const lock{ mutex_ };
+          statistics_read_ = true;
+          auto const& buckets{ statistics_.latency.buckets() };
+          return { buckets.begin(), buckets.end() };
+        });
+  }
+
   std::shared_ptr<sdbusplus::asio::connection> conn_;
-  std::unique_ptr<sdbusplus::asio::dbus_interface, std::function<void(sdbusplus::asio::dbus_interface*)>> interface_{};
-  std::function<std::optional<value_t> const&()> value_getter_{};
+  // shared with the emissions pending on the io_context of the connection, which skip it once the slot is gone
+  std::shared_ptr<sdbusplus::asio::dbus_interface> interface_{};
+  tfc::stx::small_function<receive_statistics const&()> statistics_getter_{};
+  mutable std::mutex mutex_{};  // guards what the dbus handlers read, current_, statistics_, statistics_read_ and history_
+  std::optional<value_t> current_{};
+  receive_statistics statistics_{};
+  bool statistics_read_{ true };  // since the last copy, copying the histogram on every value is not for free
+  emit_policy policy_{};
+  asio::any_io_executor executor_{ conn_ ? conn_->get_io_context().get_executor() : asio::any_io_executor{} };
+  tfc::utils::timing_wheel::handle flush_timer_{};
+  std::optional<value_t> pending_{};
+  std::optional<value_t> last_emitted_{};
+  clock::time_point last_emit_{};
+  history_t history_{};
+  std::shared_ptr<bool> alive_{ std::make_shared<bool>() };  // deferred emissions are dropped once destroyed
 };
 
 }  // namespace tfc::ipc::details
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <string>
+#include <tuple>
 
 #include <tfc/ipc/enums.hpp>
 
@@ -9,6 +11,9 @@ namespace tfc::ipc_ruler {
 
 using time_point_t = std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds>;
 
+/// \brief name, description and type of a signal or slot, as sent by the RegisterMany method
+using registration_t = std::tuple<std::string, std::string, std::uint8_t>;
+
 struct signal {
   std::string name;
   ipc::details::type_e type;
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <tfc/ipc/details/dbus_structs.hpp>
+
+namespace tfc::ipc_ruler {
+
+/**
+ * @brief
+ * Local copy of the signals and slots of the ipc ruler.
+ * ipc_manager_client fills it with one full read of the lists and keeps it up to date from the changes the ruler emits,
+ * see consts::signal_added, so lookups and the added and removed callbacks do not go over dbus.
+ * Each change carries the generation it brings the lists to, a change which does not follow the generation of the
+ * directory means one has been missed and the directory has to be assigned again.
+ */
+class directory {
+public:
+  using signal_map = std::map<std::string, signal, std::less<>>;
+  using slot_map = std::map<std::string, slot, std::less<>>;
+  using signal_callback = std::function<void(signal const&)>;
+  using slot_callback = std::function<void(slot const&)>;
+
+  [[nodiscard]] auto signals() const noexcept -> signal_map const& { return signals_; }
+  [[nodiscard]] auto slots() const noexcept -> slot_map const& { return slots_; }
+
+  /// \return the signal, nullptr if it is not known
+  [[nodiscard]] auto find_signal(std::string_view name) const -> signal const* { return find(signals_, name); }
+
+  /// \return the slot, nullptr if it is not known
+  [[nodiscard]] auto find_slot(std::string_view name) const -> slot const* { return find(slots_, name); }
+
+  [[nodiscard]] auto generation() const noexcept -> std::uint64_t { return generation_; }
+
+  /// \return true once the directory has been assigned
+  [[nodiscard]] auto synchronized() const noexcept -> bool { return synchronized_; }
+
+  /// \brief callback invoked with each signal added, including those of the first assignment
+  void on_signal_added(signal_callback callback) { signal_added_.emplace_back(std::move(callback)); }
+  /// \brief callback invoked with each signal no longer listed by the ruler
+  void on_signal_removed(signal_callback callback) { signal_removed_.emplace_back(std::move(callback)); }
+  void on_slot_added(slot_callback callback) { slot_added_.emplace_back(std::move(callback)); }
+  void on_slot_removed(slot_callback callback) { slot_removed_.emplace_back(std::move(callback)); }
+
+  /// \brief replace the content with the lists read from the ruler at the given generation
+  /// Entries not listed anymore are reported removed and new ones added, those in both are updated silently.
+  void assign(std::uint64_t generation, std::vector<signal> signals, std::vector<slot> slots) {
+    replace(signals_, std::move(signals), signal_added_, signal_removed_);
+    replace(slots_, std::move(slots), slot_added_, slot_removed_);
+    generation_ = generation;
+    synchronized_ = true;
+  }
+
+  /// \brief add or update a signal
+  /// \return false if the generation does not follow, the change is not applied and the directory needs assigning
+  [[nodiscard]] auto apply_signal(std::uint64_t generation, signal entry) -> bool {
+    if (!advance(generation)) {
+      return false;
+    }
+    upsert(signals_, std::move(entry), signal_added_);
+    return true;
+  }
+
+  /// \brief add or update a slot
+  /// \return false if the generation does not follow, the change is not applied and the directory needs assigning
+  [[nodiscard]] auto apply_slot(std::uint64_t generation, slot entry) -> bool {
+    if (!advance(generation)) {
+      return false;
+    }
+    upsert(slots_, std::move(entry), slot_added_);
+    return true;
+  }
+
+  /// \brief connect the slot to the signal, disconnect it if the signal name is empty
+  /// \return false if the generation does not follow, the change is not applied and the directory needs assigning
+  [[nodiscard]] auto apply_connection(std::uint64_t generation, std::string_view slot_name, std::string_view signal_name)
+      -> bool {
+    if (!advance(generation)) {
+      return false;
+    }
+    if (auto iter{ slots_.find(slot_name) }; iter != slots_.end()) {
+      iter->second.connected_to = signal_name;
+    }
+    return true;
+  }
+
+private:
+  auto advance(std::uint64_t generation) noexcept -> bool {
+    if (!synchronized_ || generation != generation_ + 1) {
+      return false;
+    }
+    generation_ = generation;
+    return true;
+  }
+
+  static auto find(auto const& entries, std::string_view name) -> decltype(&entries.begin()->second) {
+    auto const iter{ entries.find(name) };
+    return iter == entries.end() ? nullptr : &iter->second;
+  }
+
+  template <typename entry_t>
+  static void upsert(std::map<std::string, entry_t, std::less<>>& entries,
+                     entry_t entry,
+                     std::vector<std::function<void(entry_t const&)>> const& added) {
+    auto const name{ entry.name };
+    auto [iter, inserted]{ entries.insert_or_assign(name, std::move(entry)) };
+    if (inserted) {
+      for (auto const& callback : added) {
+        std::invoke(callback, iter->second);
+      }
+    }
+  }
+
+  template <typename entry_t>
+  static void replace(std::map<std::string, entry_t, std::less<>>& entries,
+                      std::vector<entry_t> listed,
+                      std::vector<std::function<void(entry_t const&)>> const& added,
+                      std::vector<std::function<void(entry_t const&)>> const& removed) {
+    std::map<std::string, entry_t, std::less<>> next{};
+    for (auto& entry : listed) {
+      auto name{ entry.name };
+      next.insert_or_assign(std::move(name), std::move(entry));
+    }
+    std::swap(entries, next);
+    // next now holds the former entries
+    for (auto const& [name, entry] : next) {
+      if (!entries.contains(name)) {
+        for (auto const& callback : removed) {
+          std::invoke(callback, entry);
+        }
+      }
+    }
+    for (auto const& [name, entry] : entries) {
+      if (!next.contains(name)) {
+        for (auto const& callback : added) {
+          std::invoke(callback, entry);
+        }
+      }
+    }
+  }
+
+  signal_map signals_{};
+  slot_map slots_{};
+  std::uint64_t generation_{};
+  bool synchronized_{ false };
+  std::vector<signal_callback> signal_added_{};
+  std::vector<signal_callback> signal_removed_{};
+  std::vector<slot_callback> slot_added_{};
+  std::vector<slot_callback> slot_removed_{};
+};
+
+}  // namespace tfc::ipc_ruler
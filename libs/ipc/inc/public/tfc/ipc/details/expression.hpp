@@ -0,0 +1,430 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace tfc::ipc::filter {
+
+/**
+ * @brief
+ * Arithmetic expression of one variable `x`, compiled once into a flat stack program which is evaluated without
+ * allocating. Everything is computed in double, comparisons and logical operators yield 1 or 0.
+ * @example
+ * x * 0.1 - 40
+ * clamp(x, 0, 100)
+ * x < 10 ? 0 : x < 20 ? x * 2 : 40
+ * Operators in order of precedence: ?: || && == != < <= > >= + - * / % unary - !
+ * Functions: abs ceil floor round sqrt exp log min max pow clamp
+ */
+class expression {
+public:
+  static constexpr std::size_t max_depth{ 32 };
+
+  /// \return compiled expression, invalid_argument on syntax errors, value_too_large if it is nested deeper than max_depth
+  static auto compile(std::string_view text) -> std::expected<expression, std::error_code> {
+    expression compiled{};
+    parser parsing{ text, compiled.code_ };
+    if (auto error{ parsing.parse() }) {
+      return std::unexpected(error);
+    }
+    if (parsing.max_depth() > max_depth) {
+      return std::unexpected(std::make_error_code(std::errc::value_too_large));
+    }
+    return compiled;
+  }
+
+  [[nodiscard]] auto evaluate(double x) const noexcept -> double {
+    std::array<double, max_depth> stack;  // NOLINT(cppcoreguidelines-pro-type-member-init) only read after written
+    std::size_t top{ 0 };
+    auto const binary{ [&stack, &top](auto&& operation) noexcept {
+      top--;
+      stack[top - 1] = operation(stack[top - 1], stack[top]);
+    } };
+    for (auto const& instr : code_) {
+      switch (instr.code) {
+        using enum op;
+        case constant:
+          stack[top++] = instr.constant;
+          break;
+        case variable:
+          stack[top++] = x;
+          break;
+        case negate:
+        case logical_not:
+        case abs:
+        case ceil:
+        case floor:
+        case round:
+        case sqrt:
+        case exp:
+        case log:
+          stack[top - 1] = apply_unary(instr.code, stack[top - 1]);
+          break;
+        case select:
+          top -= 2;
+          stack[top - 1] = truthy(stack[top - 1]) ? stack[top] : stack[top + 1];
+          break;
+        case clamp:
+          top -= 2;
+          stack[top - 1] = std::fmax(stack[top], std::fmin(stack[top - 1], stack[top + 1]));
+          break;
+        default:
+          binary([code = instr.code](double lhs, double rhs) noexcept { return apply_binary(code, lhs, rhs); });
+          break;
+      }
+    }
+    return stack[0];
+  }
+
+  /// \return number of instructions, constant sub expressions are folded into one
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return code_.size(); }
+
+private:
+  enum struct op : std::uint8_t {
+    constant,
+    variable,
+    negate,
+    logical_not,
+    abs,
+    ceil,
+    floor,
+    round,
+    sqrt,
+    exp,
+    log,
+    add,
+    subtract,
+    multiply,
+    divide,
+    modulo,
+    less,
+    less_equal,
+    greater,
+    greater_equal,
+    equal,
+    not_equal,
+    logical_and,
+    logical_or,
+    min,
+    max,
+    pow,
+    clamp,
+    select,
+  };
+
+  struct instruction {
+    op code{ op::constant };
+    double constant{};
+  };
+
+  static auto truthy(double value) noexcept -> bool { return std::fpclassify(value) != FP_ZERO; }
+
+  static auto apply_unary(op code, double value) noexcept -> double {
+    switch (code) {
+      using enum op;
+      case negate:
+        return -value;
+      case logical_not:
+        return truthy(value) ? 0.0 : 1.0;
+      case abs:
+        return std::fabs(value);
+      case ceil:
+        return std::ceil(value);
+      case floor:
+        return std::floor(value);
+      case round:
+        return std::round(value);
+      case sqrt:
+        return std::sqrt(value);
+      case exp:
+        return std::exp(value);
+      case log:
+        return std::log(value);
+      default:
+        return value;
+    }
+  }
+
+  static auto apply_binary(op code, double lhs, double rhs) noexcept -> double {
+    switch (code) {
+      using enum op;
+      case add:
+        return lhs + rhs;
+      case subtract:
+        return lhs - rhs;
+      case multiply:
+        return lhs * rhs;
+      case divide:
+        return lhs / rhs;
+      case modulo:
+        return std::fmod(lhs, rhs);
+      case less:
+        return lhs < rhs ? 1.0 : 0.0;
+      case less_equal:
+        return lhs <= rhs ? 1.0 : 0.0;
+      case greater:
+        return lhs > rhs ? 1.0 : 0.0;
+      case greater_equal:
+        return lhs >= rhs ? 1.0 : 0.0;
+      case equal:
+        return std::islessgreater(lhs, rhs) || std::isunordered(lhs, rhs) ? 0.0 : 1.0;
+      case not_equal:
+        return std::islessgreater(lhs, rhs) || std::isunordered(lhs, rhs) ? 1.0 : 0.0;
+      case logical_and:
+        return truthy(lhs) && truthy(rhs) ? 1.0 : 0.0;
+      case logical_or:
+        return truthy(lhs) || truthy(rhs) ? 1.0 : 0.0;
+      case min:
+        return std::fmin(lhs, rhs);
+      case max:
+        return std::fmax(lhs, rhs);
+      case pow:
+        return std::pow(lhs, rhs);
+      default:
+        return lhs;
+    }
+  }
+
+  /// \brief recursive descent parser emitting the program in postfix order
+  class parser {
+  public:
+    parser(std::string_view text, std::vector<instruction>& code) : text_{ text }, code_{ code } {}
+
+    auto parse() -> std::error_code {
+      if (!parse_conditional() || (skip_space(), pos_ != text_.size())) {
+        return std::make_error_code(too_deep_ ? std::errc::value_too_large : std::errc::invalid_argument);
+      }
+      return {};
+    }
+
+    [[nodiscard]] auto max_depth() const noexcept -> std::size_t { return max_depth_; }
+
+  private:
+    /// \brief counts nesting while parsing, so deeply nested text fails before the recursion exhausts the stack
+    class nesting_guard {
+    public:
+      explicit nesting_guard(parser& owner) noexcept : owner_{ owner } { owner_.nesting_++; }
+      nesting_guard(nesting_guard const&) = delete;
+      auto operator=(nesting_guard const&) -> nesting_guard& = delete;
+      ~nesting_guard() { owner_.nesting_--; }
+
+      /// \return true if nested too deep, parsing is to be abandoned
+      [[nodiscard]] auto exceeded() const noexcept -> bool {
+        owner_.too_deep_ = owner_.too_deep_ || owner_.nesting_ > expression::max_depth;
+        return owner_.too_deep_;
+      }
+
+    private:
+      parser& owner_;
+    };
+
+    auto parse_conditional() -> bool {
+      nesting_guard const nesting{ *this };
+      if (nesting.exceeded() || !parse_binary(0)) {
+        return false;
+      }
+      if (!consume("?")) {
+        return true;
+      }
+      if (!parse_conditional() || !consume(":") || !parse_conditional()) {
+        return false;
+      }
+      emit_operation(op::select, 3);
+      return true;
+    }
+
+    struct binary_operator {
+      std::string_view token;
+      op code;
+      std::size_t precedence;
+    };
+
+    // longer tokens first, so <= is not taken for <
+    static constexpr std::array binary_operators{
+      binary_operator{ "||", op::logical_or, 0 },   binary_operator{ "&&", op::logical_and, 1 },
+      binary_operator{ "==", op::equal, 2 },        binary_operator{ "!=", op::not_equal, 2 },
+      binary_operator{ "<=", op::less_equal, 3 },   binary_operator{ ">=", op::greater_equal, 3 },
+      binary_operator{ "<", op::less, 3 },          binary_operator{ ">", op::greater, 3 },
+      binary_operator{ "+", op::add, 4 },           binary_operator{ "-", op::subtract, 4 },
+      binary_operator{ "*", op::multiply, 5 },      binary_operator{ "/", op::divide, 5 },
+      binary_operator{ "%", op::modulo, 5 },
+    };
+    static constexpr std::size_t unary_precedence{ 6 };
+
+    /// \brief precedence climbing, every binary operator is left associative
+    auto parse_binary(std::size_t min_precedence) -> bool {
+      if (min_precedence == unary_precedence) {
+        return parse_unary();
+      }
+      if (!parse_binary(min_precedence + 1)) {
+        return false;
+      }
+      for (;;) {
+        skip_space();
+        auto const* found{ peek_binary_operator(min_precedence) };
+        if (found == nullptr) {
+          return true;
+        }
+        pos_ += found->token.size();
+        if (!parse_binary(min_precedence + 1)) {
+          return false;
+        }
+        emit_operation(found->code, 2);
+      }
+    }
+
+    auto peek_binary_operator(std::size_t precedence) const noexcept -> binary_operator const* {
+      auto const rest{ text_.substr(pos_) };
+      for (auto const& candidate : binary_operators) {
+        if (rest.starts_with(candidate.token)) {
+          // the first match is the longest token, which may belong to another precedence level
+          return candidate.precedence == precedence ? &candidate : nullptr;
+        }
+      }
+      return nullptr;
+    }
+
+    auto parse_unary() -> bool {
+      nesting_guard const nesting{ *this };
+      if (nesting.exceeded()) {
+        return false;
+      }
+      if (consume("-")) {
+        if (!parse_unary()) {
+          return false;
+        }
+        emit_operation(op::negate, 1);
+        return true;
+      }
+      if (consume("!")) {
+        if (!parse_unary()) {
+          return false;
+        }
+        emit_operation(op::logical_not, 1);
+        return true;
+      }
+      return parse_primary();
+    }
+
+    auto parse_primary() -> bool {
+      skip_space();
+      if (consume("(")) {
+        return parse_conditional() && consume(")");
+      }
+      if (pos_ < text_.size() && (std::isdigit(static_cast<unsigned char>(text_[pos_])) != 0 || text_[pos_] == '.')) {
+        double number{};
+        auto const [end, error]{ std::from_chars(text_.data() + pos_, text_.data() + text_.size(), number) };
+        if (error != std::errc{}) {
+          return false;
+        }
+        pos_ = static_cast<std::size_t>(end - text_.data());
+        push({ .code = op::constant, .constant = number });
+        return true;
+      }
+      auto const name{ identifier() };
+      if (name == "x") {
+        push({ .code = op::variable });
+        return true;
+      }
+      return parse_call(name);
+    }
+
+    auto parse_call(std::string_view name) -> bool {
+      struct function {
+        std::string_view name;
+        op code;
+        std::size_t arguments;
+      };
+      static constexpr std::array functions{
+        function{ "abs", op::abs, 1 },     function{ "ceil", op::ceil, 1 },   function{ "floor", op::floor, 1 },
+        function{ "round", op::round, 1 }, function{ "sqrt", op::sqrt, 1 },   function{ "exp", op::exp, 1 },
+        function{ "log", op::log, 1 },     function{ "min", op::min, 2 },     function{ "max", op::max, 2 },
+        function{ "pow", op::pow, 2 },     function{ "clamp", op::clamp, 3 },
+      };
+      auto const* found{ std::ranges::find(functions, name, &function::name) };
+      if (found == functions.end() || !consume("(")) {
+        return false;
+      }
+      for (std::size_t idx{ 0 }; idx < found->arguments; idx++) {
+        if ((idx > 0 && !consume(",")) || !parse_conditional()) {
+          return false;
+        }
+      }
+      if (!consume(")")) {
+        return false;
+      }
+      emit_operation(found->code, found->arguments);
+      return true;
+    }
+
+    /// \brief append an operation taking its arguments from the stack, folded if they are all constants
+    void emit_operation(op code, std::size_t arguments) {
+      auto const operands{ std::span{ code_ }.last(arguments) };
+      if (std::ranges::all_of(operands, [](instruction const& operand) { return operand.code == op::constant; })) {
+        expression folding{};
+        folding.code_.assign(operands.begin(), operands.end());
+        folding.code_.emplace_back(instruction{ .code = code });
+        auto const folded{ folding.evaluate(0.0) };
+        code_.resize(code_.size() - arguments);
+        depth_ -= arguments;
+        push({ .code = op::constant, .constant = folded });
+        return;
+      }
+      code_.emplace_back(instruction{ .code = code });
+      depth_ -= arguments - 1;
+    }
+
+    void push(instruction instr) {
+      code_.emplace_back(instr);
+      depth_++;
+      max_depth_ = std::max(max_depth_, depth_);
+    }
+
+    auto identifier() -> std::string_view {
+      skip_space();
+      auto const start{ pos_ };
+      while (pos_ < text_.size() &&
+             (std::isalnum(static_cast<unsigned char>(text_[pos_])) != 0 || text_[pos_] == '_')) {
+        pos_++;
+      }
+      return text_.substr(start, pos_ - start);
+    }
+
+    auto consume(std::string_view token) -> bool {
+      skip_space();
+      if (text_.substr(pos_).starts_with(token)) {
+        pos_ += token.size();
+        return true;
+      }
+      return false;
+    }
+
+    void skip_space() {
+      while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])) != 0) {
+        pos_++;
+      }
+    }
+
+    std::string_view text_;
+    std::vector<instruction>& code_;
+    std::size_t pos_{ 0 };
+    std::size_t depth_{ 0 };
+    std::size_t max_depth_{ 0 };
+    std::size_t nesting_{ 0 };
+    bool too_deep_{ false };
+  };
+
+  std::vector<instruction> code_{};
+};
+
+}  // namespace tfc::ipc::filter
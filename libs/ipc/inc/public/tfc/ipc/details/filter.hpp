@@ -1,20 +1,40 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include <concepts>
 #include <expected>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include <fmt/core.h>
+#include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/async_result.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/compose.hpp>
+#include <boost/asio/dispatch.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <glaze/core/common.hpp>
 
 #include <tfc/confman.hpp>
+#include <tfc/confman/observable.hpp>
+#include <tfc/ipc/details/expression.hpp>
+#include <tfc/ipc/item.hpp>
+#include <tfc/ipc/details/sliding_window.hpp>
 #include <tfc/stx/glaze_meta.hpp>
 #include <tfc/utils/pragmas.hpp>
+#include <tfc/utils/timing_wheel.hpp>
 
 namespace tfc::ipc::filter {
 
@@ -28,7 +48,6 @@ enum struct filter_e : std::uint8_t {
   multiply,
   filter_out,
   // https://esphome.io/components/sensor/index.html#sensor-filters
-  // todo: make the below filters
   calibrate_linear,  // https://github.com/esphome/esphome/blob/v1.20.4/esphome/components/sensor/__init__.py#L594
   median,
   quantile,
@@ -38,22 +57,50 @@ enum struct filter_e : std::uint8_t {
   throttle_average,
   delta,
   lambda,
-  tfc_item,  // according to item json schema see ipc/item.hpp, TODO: implement
+  tfc_item,  // according to item json schema see ipc/item.hpp
+  json_fields,
+  json_drop,
 };
 
 template <filter_e type, typename value_t, typename...>
 struct filter;
 
+namespace detail {
+/// \brief filter which processes a value without waiting for anything
+/// A chain made of these only is evaluated inline by filters, without a coroutine.
+template <typename filter_t, typename value_t>
+concept synchronous_filter = requires(filter_t const& filter, value_t&& value) {
+  { filter.process(std::move(value)) } -> std::same_as<std::expected<value_t, std::error_code>>;
+};
+
+/// \brief async_process of a synchronous filter, completes with the result of process
+template <typename value_t>
+auto async_process_inline(auto const& filter, value_t&& value, auto&& completion_token) {
+  // todo can we get a compile error if executor is non-existent?
+  auto exe = asio::get_associated_executor(completion_token);
+  return asio::async_compose<decltype(completion_token), void(std::expected<value_t, std::error_code>)>(
+      [&filter, copy = std::move(value)](auto& self) mutable { self.complete(filter.process(std::move(copy))); },
+      completion_token, exe);
+}
+
+/// \return timing wheel handler which resumes the composed operation on its associated executor, its strand if any
+auto resume_on_executor(auto&& self) {
+  return [moved = std::forward<decltype(self)>(self)](std::error_code const& code) mutable {
+    auto executor{ asio::get_associated_executor(moved) };
+    asio::dispatch(executor, [resumed = std::move(moved), code]() mutable { resumed(code); });
+  };
+}
+}  // namespace detail
+
 /// \brief behaviour flip the state of boolean
 template <>
 struct filter<filter_e::invert, bool> {
   static constexpr filter_e type{ filter_e::invert };
 
+  auto process(bool&& value) const -> std::expected<bool, std::error_code> { return !value; }
+
   auto async_process(bool&& value, auto&& completion_token) const {
-    // todo can we get a compile error if executor is non-existent?
-    auto exe = asio::get_associated_executor(completion_token);
-    return asio::async_compose<decltype(completion_token), void(std::expected<bool, std::error_code>)>(
-        [copy = value](auto& self) { self.complete(!copy); }, completion_token, exe);
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
   }
 
   struct glaze {
@@ -72,9 +119,20 @@ struct filter<filter_e::timer, bool, clock_type> {
   static constexpr filter_e type{ filter_e::timer };
 
   filter() = default;
-  // if the filter is moved everything is moved
-  filter(filter&&) noexcept = default;
-  auto operator=(filter&&) noexcept -> filter& = default;
+  // if the filter is moved everything is moved, the pending timer is owned by the new filter
+  filter(filter&& other) noexcept
+      : time_on{ other.time_on }, time_off{ other.time_off }, wheel_{ other.wheel_ },
+        pending_{ std::exchange(other.pending_, {}) } {}
+  auto operator=(filter&& other) noexcept -> filter& {
+    if (this != &other) {
+      cancel();
+      time_on = other.time_on;
+      time_off = other.time_off;
+      wheel_ = other.wheel_;
+      pending_ = std::exchange(other.pending_, {});
+    }
+    return *this;
+  }
   // if the filter is copied the data will be copied, the copied object will hold on to its timer `other`
   filter(filter const& other) {
     this->time_on = other.time_on;
@@ -85,6 +143,7 @@ struct filter<filter_e::timer, bool, clock_type> {
     this->time_off = other.time_off;
     return *this;
   }
+  ~filter() { cancel(); }
 
   // async_process is const to not require making change to config object while processing the filter state
   auto async_process(bool&& value, auto&& completion_token) const {
@@ -98,31 +157,35 @@ struct filter<filter_e::timer, bool, clock_type> {
             self.complete(std::unexpected(code));
             return;
           }
-          // second call meaning success, call owner and return
+          // second call meaning success, call owner and return, the filter may have been moved by now
           if (!first_call) {
-            timer_ = std::nullopt;
             self.complete(copy);
             return;
           }
           first_call = false;
-          if (timer_) {
-            // already waiting need to cancel and return
-            timer_->cancel();  // this will make a recall to this very same lambda with error code
-            timer_ = std::nullopt;
+          wheel_ = &wheel_t::of(asio::get_associated_executor(self));
+          if (wheel_->cancel(pending_)) {
+            // already waiting, the waiting one is called back with an error code and this event is dropped
             return;
           }
-          auto executor = asio::get_associated_executor(self);
-          timer_ = asio::basic_waitable_timer<clock_type>{ executor };
-          timer_->expires_after(copy ? time_on : time_off);
           // moving self makes this callback be called once again when expiry is reached or timer is cancelled
-          timer_->async_wait(std::move(self));
+          pending_ = wheel_->schedule_after(copy ? time_on : time_off, detail::resume_on_executor(std::move(self)));
         },
         completion_token, exe);
   }
 
 private:
+  using wheel_t = tfc::utils::basic_timing_wheel<clock_type>;
+
+  void cancel() {
+    if (wheel_ != nullptr) {
+      wheel_->cancel(pending_);
+    }
+  }
+
   // mutable is required since async_process is const
-  mutable std::optional<asio::basic_waitable_timer<clock_type>> timer_{ std::nullopt };
+  mutable wheel_t* wheel_{ nullptr };
+  mutable typename wheel_t::handle pending_{};
 
 public:
   struct glaze {
@@ -143,14 +206,10 @@ struct filter<filter_e::offset, value_t> {
   value_t offset{};
   static constexpr filter_e type{ filter_e::offset };
 
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> { return value + offset; }
+
   auto async_process(value_t&& value, auto&& completion_token) const {
-    // todo can we get a compile error if executor is non-existent?
-    auto exe = asio::get_associated_executor(completion_token);
-    return asio::async_compose<decltype(completion_token), void(std::expected<value_t, std::error_code>)>(
-        [this, copy = value](auto& self) {
-          self.complete(copy + offset);  //
-        },
-        completion_token, exe);
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
   }
 
   struct glaze {
@@ -166,14 +225,10 @@ struct filter<filter_e::multiply, value_t> {
   value_t multiply{};
   static constexpr filter_e type{ filter_e::multiply };
 
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> { return value * multiply; }
+
   auto async_process(value_t&& value, auto&& completion_token) const {
-    // todo can we get a compile error if executor is non-existent?
-    auto exe = asio::get_associated_executor(completion_token);
-    return asio::async_compose<decltype(completion_token), void(std::expected<value_t, std::error_code>)>(
-        [this, copy = value](auto& self) {
-          self.complete(copy * multiply);  //
-        },
-        completion_token, exe);
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
   }
 
   struct glaze {
@@ -188,22 +243,20 @@ struct filter<filter_e::filter_out, value_t> {
   value_t filter_out{};
   static constexpr filter_e type{ filter_e::filter_out };
 
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    // Todo should this filter be available for double?
+    // clang-format off
+    PRAGMA_CLANG_WARNING_PUSH_OFF(-Wfloat-equal)
+    if (value == filter_out) {
+    PRAGMA_CLANG_WARNING_POP
+      // clang-format on
+      return std::unexpected(std::make_error_code(std::errc::bad_message));
+    }
+    return std::move(value);
+  }
+
   auto async_process(value_t&& value, auto&& completion_token) const {
-    auto executor{ asio::get_associated_executor(completion_token) };
-    return asio::async_compose<decltype(completion_token), void(std::expected<value_t, std::error_code>)>(
-        [this, moved_value = std::move(value)](auto& self) {
-          // Todo should this filter be available for double?
-          // clang-format off
-          PRAGMA_CLANG_WARNING_PUSH_OFF(-Wfloat-equal)
-          if (moved_value == filter_out) {
-          PRAGMA_CLANG_WARNING_POP
-            // clang-format on
-            self.complete(std::unexpected(std::make_error_code(std::errc::bad_message)));
-          } else {
-            self.complete(moved_value);
-          }
-        },
-        completion_token, executor);
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
   }
 
   struct glaze {
@@ -215,59 +268,1058 @@ struct filter<filter_e::filter_out, value_t> {
   };
 };
 
+/// \brief window of the latest values of a sliding window filter, options as in ESPHome
+struct window_config {
+  std::size_t window_size{ 5 };
+  std::size_t send_every{ 5 };
+  std::size_t send_first_at{ 1 };
+
+  struct glaze {
+    using type = window_config;
+    static constexpr std::string_view name{ "tfc::ipc::filter::window_config" };
+    // clang-format off
+    static constexpr auto value{ glz::object(
+      "window_size", &type::window_size, "Number of latest values to compute the output from",
+      "send_every", &type::send_every, "Output once every this many values",
+      "send_first_at", &type::send_first_at, "Output the first time after this many values, at most send_every"
+    ) };
+    // clang-format on
+  };
+};
+
+struct quantile_config {
+  std::size_t window_size{ 5 };
+  std::size_t send_every{ 5 };
+  std::size_t send_first_at{ 1 };
+  double quantile{ 0.9 };
+
+  struct glaze {
+    using type = quantile_config;
+    static constexpr std::string_view name{ "tfc::ipc::filter::quantile_config" };
+    // clang-format off
+    static constexpr auto value{ glz::object(
+      "window_size", &type::window_size, "Number of latest values to compute the output from",
+      "send_every", &type::send_every, "Output once every this many values",
+      "send_first_at", &type::send_first_at, "Output the first time after this many values, at most send_every",
+      "quantile", &type::quantile, "Quantile of the window to output, between 0 and 1"
+    ) };
+    // clang-format on
+  };
+};
+
+namespace detail {
+/// \return unexpected if the value can not be ordered or summed
+template <typename value_t>
+auto check_windowable(value_t const& value) -> std::expected<void, std::error_code> {
+  if constexpr (std::floating_point<value_t>) {
+    if (std::isnan(value)) {
+      return std::unexpected(std::make_error_code(std::errc::argument_out_of_domain));
+    }
+  }
+  return {};
+}
+
+/// \brief the value a sliding window filter holds back until it is its turn to send
+inline auto not_sent() -> std::error_code {
+  return std::make_error_code(std::errc::operation_in_progress);
+}
+}  // namespace detail
+
+/// \brief behaviour median of the latest window_size values, O(log window_size) per value
+/// \note filter state is reset when the window is reconfigured
+template <typename value_t>
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::median, value_t> {
+  window_config median{};
+  static constexpr filter_e type{ filter_e::median };
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    if (auto valid{ detail::check_windowable(value) }; !valid) {
+      return std::unexpected(valid.error());
+    }
+    if (!window_.push(value, median.window_size, median.send_every, median.send_first_at)) {
+      return std::unexpected(detail::not_sent());
+    }
+    auto const& sorted{ window_.window() };
+    auto const size{ sorted.size() };
+    if (size % 2 == 1) {
+      return sorted.nth(size / 2);
+    }
+    return std::midpoint(sorted.nth(size / 2 - 1), sorted.nth(size / 2));
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable detail::send_every_window<detail::sorted_window<value_t>> window_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::median, value_t>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::median" };
+    static constexpr auto value{ glz::object("median", &type::median, "Median of a sliding window of values.") };
+  };
+};
+
+/// \brief behaviour quantile of the latest window_size values, O(log window_size) per value
+/// \note filter state is reset when the window is reconfigured
+template <typename value_t>
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::quantile, value_t> {
+  quantile_config quantile{};
+  static constexpr filter_e type{ filter_e::quantile };
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    if (auto valid{ detail::check_windowable(value) }; !valid) {
+      return std::unexpected(valid.error());
+    }
+    if (!window_.push(value, quantile.window_size, quantile.send_every, quantile.send_first_at)) {
+      return std::unexpected(detail::not_sent());
+    }
+    auto const& sorted{ window_.window() };
+    auto const size{ static_cast<double>(sorted.size()) };
+    auto const position{ std::ceil(size * std::clamp(quantile.quantile, 0.0, 1.0)) - 1.0 };
+    return sorted.nth(static_cast<std::size_t>(std::clamp(position, 0.0, size - 1.0)));
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable detail::send_every_window<detail::sorted_window<value_t>> window_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::quantile, value_t>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::quantile" };
+    static constexpr auto value{ glz::object("quantile", &type::quantile, "Quantile of a sliding window of values.") };
+  };
+};
+
+/// \brief behaviour mean of the latest window_size values, O(1) per value
+/// \note filter state is reset when the window is reconfigured
+template <typename value_t>
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::sliding_window_moving_average, value_t> {
+  window_config sliding_window_moving_average{ .window_size = 15, .send_every = 15, .send_first_at = 1 };
+  static constexpr filter_e type{ filter_e::sliding_window_moving_average };
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    if (auto valid{ detail::check_windowable(value) }; !valid) {
+      return std::unexpected(valid.error());
+    }
+    auto const& config{ sliding_window_moving_average };
+    if (!window_.push(value, config.window_size, config.send_every, config.send_first_at)) {
+      return std::unexpected(detail::not_sent());
+    }
+    auto const mean{ window_.window().mean() };
+    if constexpr (std::integral<value_t>) {
+      return static_cast<value_t>(std::round(mean));
+    } else {
+      return static_cast<value_t>(mean);
+    }
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable detail::send_every_window<detail::summed_window<value_t>> window_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::sliding_window_moving_average, value_t>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::sliding_window_moving_average" };
+    static constexpr auto value{ glz::object("sliding_window_moving_average",
+                                             &type::sliding_window_moving_average,
+                                             "Mean of a sliding window of values.") };
+  };
+};
+
+struct exponential_moving_average_config {
+  double alpha{ 0.1 };
+  std::size_t send_every{ 15 };
+  std::size_t send_first_at{ 1 };
+
+  struct glaze {
+    using type = exponential_moving_average_config;
+    static constexpr std::string_view name{ "tfc::ipc::filter::exponential_moving_average_config" };
+    // clang-format off
+    static constexpr auto value{ glz::object(
+      "alpha", &type::alpha, "Weight of the latest value, between 0 and 1",
+      "send_every", &type::send_every, "Output once every this many values",
+      "send_first_at", &type::send_first_at, "Output the first time after this many values, at most send_every"
+    ) };
+    // clang-format on
+  };
+};
+
+/// \brief behaviour exponentially weighted mean of all values, the first value seeds the mean
+/// \note filter state is reset when send_every or send_first_at is reconfigured
+template <typename value_t>
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::exponential_moving_average, value_t> {
+  exponential_moving_average_config exponential_moving_average{};
+  static constexpr filter_e type{ filter_e::exponential_moving_average };
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    if (auto valid{ detail::check_windowable(value) }; !valid) {
+      return std::unexpected(valid.error());
+    }
+    auto const& config{ exponential_moving_average };
+    if (auto const sending{ std::pair{ config.send_every, config.send_first_at } }; sending_ != sending) {
+      sending_ = sending;
+      average_ = std::nullopt;
+      counter_.reset(config.send_every, config.send_first_at);
+    }
+    auto const alpha{ static_cast<long double>(std::clamp(config.alpha, 0.0, 1.0)) };
+    average_ = average_ ? alpha * static_cast<long double>(value) + (1.0L - alpha) * average_.value()
+                        : static_cast<long double>(value);
+    if (!counter_.next()) {
+      return std::unexpected(detail::not_sent());
+    }
+    if constexpr (std::integral<value_t>) {
+      return static_cast<value_t>(std::round(average_.value()));
+    } else {
+      return static_cast<value_t>(average_.value());
+    }
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable std::optional<std::pair<std::size_t, std::size_t>> sending_{};
+  mutable std::optional<long double> average_{};
+  mutable detail::send_counter counter_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::exponential_moving_average, value_t>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::exponential_moving_average" };
+    static constexpr auto value{ glz::object("exponential_moving_average",
+                                             &type::exponential_moving_average,
+                                             "Exponentially weighted mean of the values.") };
+  };
+};
+
+/// \brief behaviour pass on at most one value per throttle period, the values in between are dropped
+/// Evaluated when a value arrives, no timer is involved.
+template <typename value_t, typename clock_type>  // example std::chrono::steady_clock
+struct filter<filter_e::throttle, value_t, clock_type> {
+  std::chrono::milliseconds throttle{ 0 };
+  static constexpr filter_e type{ filter_e::throttle };
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    auto const now{ clock_type::now() };
+    if (last_sent_ && now - last_sent_.value() < throttle) {
+      return std::unexpected(detail::not_sent());
+    }
+    last_sent_ = now;
+    return std::move(value);
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable std::optional<typename clock_type::time_point> last_sent_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::throttle, value_t, clock_type>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::throttle" };
+    static constexpr auto value{
+      glz::object("throttle", &type::throttle, "Minimum time between values passed on, others are dropped")
+    };
+  };
+};
+
+/// \brief behaviour mean of the values received within each throttle_average period, output when the period ends
+/// The first value of a period waits for the end of it and completes with the mean, the others complete right away
+/// with an error. The period is a timer of the timing wheel of the io_context, no asio timer is made per filter.
+/// \note IMPORTANT: period changes take effect on next period
+template <typename value_t, typename clock_type>  // example std::chrono::steady_clock
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::throttle_average, value_t, clock_type> {
+  std::chrono::milliseconds throttle_average{ 0 };
+  static constexpr filter_e type{ filter_e::throttle_average };
+
+  filter() = default;
+  // if the filter is moved everything is moved, the pending period is owned by the new filter
+  filter(filter&& other) noexcept
+      : throttle_average{ other.throttle_average }, wheel_{ other.wheel_ }, pending_{ std::exchange(other.pending_, {}) },
+        sum_{ other.sum_ }, count_{ other.count_ } {}
+  auto operator=(filter&& other) noexcept -> filter& {
+    if (this != &other) {
+      cancel();
+      throttle_average = other.throttle_average;
+      wheel_ = other.wheel_;
+      pending_ = std::exchange(other.pending_, {});
+      sum_ = other.sum_;
+      count_ = other.count_;
+    }
+    return *this;
+  }
+  // if the filter is copied the data will be copied, the copied object will hold on to its timer `other`
+  filter(filter const& other) : throttle_average{ other.throttle_average } {}
+  auto operator=(filter const& other) -> filter& {
+    this->throttle_average = other.throttle_average;
+    return *this;
+  }
+  ~filter() { cancel(); }
+
+  // async_process is const to not require making change to config object while processing the filter state
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    auto exe = asio::get_associated_executor(completion_token);
+    return asio::async_compose<decltype(completion_token), void(std::expected<value_t, std::error_code>)>(
+        [this, copy = value, first_call = true](auto& self, std::error_code code = {}) mutable {
+          if (code) {
+            // The timer was cancelled, the filter is being destroyed
+            self.complete(std::unexpected(code));
+            return;
+          }
+          if (!first_call) {
+            // The period has ended, output the mean of its values and start over
+            auto const mean{ sum_ / static_cast<long double>(count_) };
+            sum_ = 0;
+            count_ = 0;
+            if constexpr (std::integral<value_t>) {
+              self.complete(static_cast<value_t>(std::round(mean)));
+            } else {
+              self.complete(static_cast<value_t>(mean));
+            }
+            return;
+          }
+          first_call = false;
+          if (auto valid{ detail::check_windowable(copy) }; !valid) {
+            self.complete(std::unexpected(valid.error()));
+            return;
+          }
+          sum_ += static_cast<long double>(copy);
+          if (count_++ > 0) {
+            self.complete(std::unexpected(detail::not_sent()));  // the first value of the period is waiting
+            return;
+          }
+          wheel_ = &wheel_t::of(asio::get_associated_executor(self));
+          // moving self makes this callback be called once again when the period ends
+          pending_ = wheel_->schedule_after(throttle_average, detail::resume_on_executor(std::move(self)));
+        },
+        completion_token, exe);
+  }
+
+private:
+  using wheel_t = tfc::utils::basic_timing_wheel<clock_type>;
+
+  void cancel() {
+    if (wheel_ != nullptr) {
+      wheel_->cancel(pending_);
+    }
+  }
+
+  // mutable is required since async_process is const
+  mutable wheel_t* wheel_{ nullptr };
+  mutable typename wheel_t::handle pending_{};
+  mutable long double sum_{};
+  mutable std::size_t count_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::throttle_average, value_t, clock_type>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::throttle_average" };
+    static constexpr auto value{
+      glz::object("throttle_average", &type::throttle_average, "Period to output the mean of the values received in")
+    };
+  };
+};
+
+/// \brief behaviour pass on a value only if it differs from the last value passed on by at least delta
+template <typename value_t>
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::delta, value_t> {
+  value_t delta{};
+  static constexpr filter_e type{ filter_e::delta };
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    if (auto valid{ detail::check_windowable(value) }; !valid) {
+      return std::unexpected(valid.error());
+    }
+    if (last_sent_) {
+      // the difference of unsigned values is taken in the direction it does not wrap
+      auto const difference{ value > last_sent_.value() ? value - last_sent_.value() : last_sent_.value() - value };
+      if (difference < delta) {
+        return std::unexpected(detail::not_sent());
+      }
+    }
+    last_sent_ = value;
+    return std::move(value);
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable std::optional<value_t> last_sent_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::delta, value_t>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::delta" };
+    static constexpr auto value{
+      glz::object("delta", &type::delta, "Minimum difference from the last value passed on, smaller changes are dropped")
+    };
+  };
+};
+
+/// \brief pair of a raw value and the actual value it corresponds to, measured when calibrating
+struct calibration_point {
+  double raw{};
+  double actual{};
+
+  auto operator==(calibration_point const& other) const noexcept -> bool {
+    // clang-format off
+    PRAGMA_CLANG_WARNING_PUSH_OFF(-Wfloat-equal)
+    return raw == other.raw && actual == other.actual;
+    PRAGMA_CLANG_WARNING_POP
+    // clang-format on
+  }
+
+  struct glaze {
+    using type = calibration_point;
+    static constexpr std::string_view name{ "tfc::ipc::filter::calibration_point" };
+    // clang-format off
+    static constexpr auto value{ glz::object(
+      "raw", &type::raw, "Value as received",
+      "actual", &type::actual, "Value it is supposed to be"
+    ) };
+    // clang-format on
+  };
+};
+
+/// \brief behaviour maps values onto the least squares line through the calibration points
+/// The line is fitted when the points are (re)configured, each value costs a single fused multiply add.
+/// A single point makes the filter an offset, no points leave the values as they are.
+template <typename value_t>
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::calibrate_linear, value_t> {
+  tfc::confman::observable<std::vector<calibration_point>> calibrate_linear{};
+  static constexpr filter_e type{ filter_e::calibrate_linear };
+
+  filter() { observe(); }
+  // the observer refers to this filter, so it is registered anew by each copy and move
+  filter(filter&& other) noexcept
+      : calibrate_linear{ std::move(other.calibrate_linear) }, slope_{ other.slope_ }, intercept_{ other.intercept_ } {
+    observe();
+  }
+  filter(filter const& other)
+      : calibrate_linear{ other.calibrate_linear }, slope_{ other.slope_ }, intercept_{ other.intercept_ } {
+    observe();
+  }
+  auto operator=(filter&& other) noexcept -> filter& {
+    calibrate_linear = std::move(other.calibrate_linear);
+    slope_ = other.slope_;
+    intercept_ = other.intercept_;
+    observe();
+    return *this;
+  }
+  auto operator=(filter const& other) -> filter& {
+    if (this != &other) {
+      calibrate_linear = other.calibrate_linear;
+      slope_ = other.slope_;
+      intercept_ = other.intercept_;
+      observe();
+    }
+    return *this;
+  }
+  ~filter() = default;
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    auto const calibrated{ std::fma(static_cast<double>(value), slope_, intercept_) };
+    if constexpr (std::integral<value_t>) {
+      return static_cast<value_t>(std::round(calibrated));
+    } else {
+      return static_cast<value_t>(calibrated);
+    }
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+  [[nodiscard]] auto slope() const noexcept -> double { return slope_; }
+  [[nodiscard]] auto intercept() const noexcept -> double { return intercept_; }
+
+private:
+  void observe() {
+    calibrate_linear.observe(
+        [this](std::vector<calibration_point> const& new_value, std::vector<calibration_point> const&) noexcept {
+          fit(new_value);
+        });
+  }
+
+  void fit(std::vector<calibration_point> const& points) noexcept {
+    slope_ = 1.0;
+    intercept_ = 0.0;
+    if (points.empty()) {
+      return;
+    }
+    auto const count{ static_cast<double>(points.size()) };
+    double sum_raw{};
+    double sum_actual{};
+    for (auto const& point : points) {
+      sum_raw += point.raw;
+      sum_actual += point.actual;
+    }
+    auto const mean_raw{ sum_raw / count };
+    auto const mean_actual{ sum_actual / count };
+    // centered sums, more precise than the textbook formula when raw values are large
+    double covariance{};
+    double variance{};
+    for (auto const& point : points) {
+      covariance += (point.raw - mean_raw) * (point.actual - mean_actual);
+      variance += (point.raw - mean_raw) * (point.raw - mean_raw);
+    }
+    if (variance > 0.0) {
+      slope_ = covariance / variance;
+    }
+    intercept_ = mean_actual - slope_ * mean_raw;
+  }
+
+  double slope_{ 1.0 };
+  double intercept_{ 0.0 };
+
+public:
+  struct glaze {
+    using type = filter<filter_e::calibrate_linear, value_t>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::calibrate_linear" };
+    static constexpr auto value{ glz::object("calibrate_linear",
+                                             &type::calibrate_linear,
+                                             "Points of raw and actual values to fit a line through.") };
+  };
+};
+
+/// \brief behaviour output of an expression of the value `x`, see expression for the syntax
+/// The expression is compiled when it is (re)configured, an invalid one drops every value with the compile error.
+/// Values the expression maps outside of what value_t can hold are dropped.
+template <typename value_t>
+  requires requires { requires(std::integral<value_t> || std::floating_point<value_t>) && !std::same_as<value_t, bool>; }
+struct filter<filter_e::lambda, value_t> {
+  tfc::confman::observable<std::string> lambda{ std::string{ "x" } };
+  static constexpr filter_e type{ filter_e::lambda };
+
+  filter() { observe(); }
+  // the observer refers to this filter, so it is registered anew by each copy and move
+  filter(filter&& other) noexcept : lambda{ std::move(other.lambda) }, program_{ std::move(other.program_) } { observe(); }
+  filter(filter const& other) : lambda{ other.lambda }, program_{ other.program_ } { observe(); }
+  auto operator=(filter&& other) noexcept -> filter& {
+    lambda = std::move(other.lambda);
+    program_ = std::move(other.program_);
+    observe();
+    return *this;
+  }
+  auto operator=(filter const& other) -> filter& {
+    if (this != &other) {
+      lambda = other.lambda;
+      program_ = other.program_;
+      observe();
+    }
+    return *this;
+  }
+  ~filter() = default;
+
+  auto process(value_t&& value) const -> std::expected<value_t, std::error_code> {
+    if (!program_) {
+      return std::unexpected(program_.error());
+    }
+    auto const result{ program_->evaluate(static_cast<double>(value)) };
+    if constexpr (std::integral<value_t>) {
+      auto const rounded{ std::round(result) };
+      // NaN fails both comparisons
+      if (!(rounded >= static_cast<double>(std::numeric_limits<value_t>::lowest()) &&
+            rounded < static_cast<double>(std::numeric_limits<value_t>::max()))) {
+        return std::unexpected(std::make_error_code(std::errc::result_out_of_range));
+      }
+      return static_cast<value_t>(rounded);
+    } else {
+      if (!std::isfinite(result)) {
+        return std::unexpected(std::make_error_code(std::errc::result_out_of_range));
+      }
+      return static_cast<value_t>(result);
+    }
+  }
+
+  auto async_process(value_t&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  void observe() {
+    lambda.observe([this](std::string const& new_value, std::string const&) noexcept {
+      program_ = expression::compile(new_value);
+    });
+  }
+
+  std::expected<expression, std::error_code> program_{ expression::compile("x") };
+
+public:
+  struct glaze {
+    using type = filter<filter_e::lambda, value_t>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::lambda" };
+    static constexpr auto value{
+      glz::object("lambda",
+                  &type::lambda,
+                  "Expression of the value x, example: x * 0.1 - 40. Operators: ?: || && == != < <= > >= + - * / % ! "
+                  "and functions: abs ceil floor round sqrt exp log min max pow clamp")
+    };
+  };
+};
+
+namespace detail {
+/**
+ * @brief
+ * Top level fields of a json object, each kept as the json text of its value so only what a filter looks at is parsed.
+ * The object is scanned once and only the fields a filter asks for are copied, the values of other fields are skipped
+ * without being parsed or stored. Entries are reused from one value to the next which does not allocate once the same
+ * fields keep arriving.
+ */
+class json_object_fields {
+public:
+  /// \param keys fields to keep, any other field is skipped so arbitrary keys do not accumulate
+  /// \note the kept values are only delimited, their contents are checked by whoever parses them
+  auto scan(std::string const& json, std::span<std::string const> keys) -> std::error_code {
+    std::erase_if(fields_, [keys](auto const& entry) { return std::ranges::find(keys, entry.first) == keys.end(); });
+    for (auto const& key : keys) {
+      fields_.try_emplace(key).first->second.str.clear();  // keeps the capacity, cleared fields are absent from this value
+    }
+    std::string_view rest{ json };
+    if (!take(rest, '{')) {
+      return std::make_error_code(std::errc::bad_message);
+    }
+    bool more{ !take(rest, '}') };
+    while (more) {
+      auto const key{ take_string(rest) };
+      if (!key || !take(rest, ':')) {
+        return std::make_error_code(std::errc::bad_message);
+      }
+      auto const value{ take_value(rest) };
+      if (!value) {
+        return std::make_error_code(std::errc::bad_message);
+      }
+      if (auto const field{ find_field(key.value()) }; field != fields_.end()) {
+        field->second.str.assign(value.value());
+      }
+      more = take(rest, ',');
+      if (!more && !take(rest, '}')) {
+        return std::make_error_code(std::errc::bad_message);
+      }
+    }
+    skip_whitespace(rest);
+    if (!rest.empty()) {
+      return std::make_error_code(std::errc::bad_message);
+    }
+    return {};
+  }
+
+  /// \return json text of the field, nullopt if the value has no such field
+  [[nodiscard]] auto find(std::string_view key) const -> std::optional<std::string_view> {
+    auto const found{ fields_.find(key) };
+    if (found == fields_.end() || found->second.str.empty()) {
+      return std::nullopt;
+    }
+    return found->second.str;
+  }
+
+private:
+  using fields_t = std::map<std::string, glz::raw_json, std::less<>>;
+
+  static void skip_whitespace(std::string_view& rest) noexcept {
+    auto const begin{ rest.find_first_not_of(" \t\n\r") };
+    rest.remove_prefix(begin == std::string_view::npos ? rest.size() : begin);
+  }
+
+  /// \return true if the next token is character, which is then consumed
+  static auto take(std::string_view& rest, char character) noexcept -> bool {
+    skip_whitespace(rest);
+    if (rest.empty() || rest.front() != character) {
+      return false;
+    }
+    rest.remove_prefix(1);
+    return true;
+  }
+
+  /// \return json text of the next string including its quotes, nullopt if there is none
+  static auto take_string(std::string_view& rest) noexcept -> std::optional<std::string_view> {
+    skip_whitespace(rest);
+    if (rest.empty() || rest.front() != '"') {
+      return std::nullopt;
+    }
+    for (std::size_t idx{ 1 }; idx < rest.size(); idx++) {
+      if (rest[idx] == '\\') {
+        idx++;
+      } else if (rest[idx] == '"') {
+        auto const token{ rest.substr(0, idx + 1) };
+        rest.remove_prefix(idx + 1);
+        return token;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// \return json text of the next value, nullopt if it is not delimited
+  static auto take_value(std::string_view& rest) noexcept -> std::optional<std::string_view> {
+    skip_whitespace(rest);
+    if (rest.empty()) {
+      return std::nullopt;
+    }
+    if (rest.front() == '"') {
+      return take_string(rest);
+    }
+    std::size_t depth{};
+    std::size_t idx{};
+    while (idx < rest.size()) {
+      auto const character{ rest[idx] };
+      if (character == '"') {
+        auto tail{ rest.substr(idx) };
+        if (!take_string(tail)) {
+          return std::nullopt;
+        }
+        idx = rest.size() - tail.size();
+        continue;
+      }
+      if (character == '{' || character == '[') {
+        depth++;
+      } else if (character == '}' || character == ']') {
+        if (depth == 0) {
+          break;  // closes the object holding the value
+        }
+        depth--;
+      } else if (depth == 0 && (character == ',' || character == ' ' || character == '\t' || character == '\n' ||
+                                character == '\r')) {
+        break;
+      }
+      idx++;
+    }
+    if (idx == 0 || depth != 0) {
+      return std::nullopt;
+    }
+    auto const token{ rest.substr(0, idx) };
+    rest.remove_prefix(idx);
+    return token;
+  }
+
+  /// \param key json text of a key including its quotes
+  auto find_field(std::string_view key) -> fields_t::iterator {
+    key = key.substr(1, key.size() - 2);
+    if (!key.contains('\\')) {
+      return fields_.find(key);
+    }
+    // Only keys with escapes are unescaped, into a buffer which keeps its capacity
+    key_buffer_.clear();
+    if (glz::read_json(key_buffer_, fmt::format("\"{}\"", key))) {
+      return fields_.end();
+    }
+    return fields_.find(key_buffer_);
+  }
+
+  fields_t fields_{};
+  std::string key_buffer_{};
+};
+
+/// \brief copy json text to out without the whitespace outside of strings
+/// \param out cleared first, keeps its capacity
+inline void minify_json(std::string_view json, std::string& out) {
+  out.clear();
+  bool in_string{ false };
+  bool escaped{ false };
+  for (char const character : json) {
+    if (in_string) {
+      in_string = escaped || character != '"';
+      escaped = !escaped && character == '\\';
+    } else if (character == ' ' || character == '\t' || character == '\n' || character == '\r') {
+      continue;
+    } else {
+      in_string = character == '"';
+    }
+    out.push_back(character);
+  }
+}
+}  // namespace detail
+
+/// \brief behaviour keep only the listed top level fields of a json object
+template <>
+struct filter<filter_e::json_fields, std::string> {
+  std::vector<std::string> json_fields{};
+  static constexpr filter_e type{ filter_e::json_fields };
+
+  auto process(std::string&& value) const -> std::expected<std::string, std::error_code> {
+    if (auto error{ fields_.scan(value, json_fields) }) {
+      return std::unexpected(error);
+    }
+    // The value is written into the buffer of the former value, and the buffer of this one is kept for the next
+    std::swap(value, buffer_);
+    value.clear();
+    value.push_back('{');
+    for (auto const& key : json_fields) {
+      if (auto const field{ fields_.find(key) }) {
+        if (value.size() > 1) {
+          value.push_back(',');
+        }
+        glz::write_json(key, key_buffer_);  // quoted and escaped
+        value.append(key_buffer_);
+        value.push_back(':');
+        value.append(field.value());
+      }
+    }
+    value.push_back('}');
+    return std::move(value);
+  }
+
+  auto async_process(std::string&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable detail::json_object_fields fields_{};
+  mutable std::string buffer_{};
+  mutable std::string key_buffer_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::json_fields, std::string>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::json_fields" };
+    static constexpr auto value{
+      glz::object("json_fields", &type::json_fields, "Top level fields of json objects to keep, others are removed")
+    };
+  };
+};
+
+struct json_drop_config {
+  std::string field{};
+  glz::raw_json equals{};
+
+  struct glaze {
+    using type = json_drop_config;
+    static constexpr std::string_view name{ "tfc::ipc::filter::json_drop_config" };
+    // clang-format off
+    static constexpr auto value{ glz::object(
+      "field", &type::field, "Top level field of json objects to compare",
+      "equals", &type::equals, "Drop objects where the field is this json value, compared as compact json"
+    ) };
+    // clang-format on
+  };
+};
+
+/// \brief behaviour drop json objects which have a given value in a field
+template <>
+struct filter<filter_e::json_drop, std::string> {
+  json_drop_config json_drop{};
+  static constexpr filter_e type{ filter_e::json_drop };
+
+  auto process(std::string&& value) const -> std::expected<std::string, std::error_code> {
+    if (auto error{ fields_.scan(value, std::span{ &json_drop.field, 1 }) }) {
+      return std::unexpected(error);
+    }
+    auto const field{ fields_.find(json_drop.field) };
+    if (!field) {
+      return std::move(value);
+    }
+    detail::minify_json(field.value(), field_buffer_);
+    detail::minify_json(json_drop.equals.str, equals_buffer_);
+    if (field_buffer_ == equals_buffer_) {
+      return std::unexpected(std::make_error_code(std::errc::bad_message));
+    }
+    return std::move(value);
+  }
+
+  auto async_process(std::string&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable detail::json_object_fields fields_{};
+  mutable std::string field_buffer_{};
+  mutable std::string equals_buffer_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::json_drop, std::string>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::json_drop" };
+    static constexpr auto value{ glz::object("json_drop", &type::json_drop, "Drop json objects by the value of a field") };
+  };
+};
+
+struct tfc_item_config {
+  std::vector<std::string> required{};
+
+  struct glaze {
+    using type = tfc_item_config;
+    static constexpr std::string_view name{ "tfc::ipc::filter::tfc_item_config" };
+    static constexpr auto value{
+      glz::object("required", &type::required, "Fields items need to have besides being valid, example: item_id")
+    };
+  };
+};
+
+/// \brief behaviour drop values which are not items, see ipc/item.hpp, or lack a required field
+template <>
+struct filter<filter_e::tfc_item, std::string> {
+  tfc_item_config tfc_item{};
+  static constexpr filter_e type{ filter_e::tfc_item };
+
+  auto process(std::string&& value) const -> std::expected<std::string, std::error_code> {
+    if (!tfc_item.required.empty()) {
+      // the cheap check first, the field is there and not null
+      if (auto error{ fields_.scan(value, tfc_item.required) }) {
+        return std::unexpected(error);
+      }
+      for (auto const& key : tfc_item.required) {
+        if (auto const field{ fields_.find(key) }; !field || field.value() == "null") {
+          return std::unexpected(std::make_error_code(std::errc::bad_message));
+        }
+      }
+    }
+    if (!ipc::item::item::validate(value, buffer_)) {
+      return std::unexpected(std::make_error_code(std::errc::bad_message));
+    }
+    return std::move(value);
+  }
+
+  auto async_process(std::string&& value, auto&& completion_token) const {
+    return detail::async_process_inline(*this, std::move(value), std::forward<decltype(completion_token)>(completion_token));
+  }
+
+private:
+  // mutable is required since process is const
+  mutable detail::json_object_fields fields_{};
+  mutable ipc::item::item buffer_{};
+
+public:
+  struct glaze {
+    using type = filter<filter_e::tfc_item, std::string>;
+    static constexpr std::string_view name{ "tfc::ipc::filter::tfc_item" };
+    static constexpr auto value{ glz::object("tfc_item", &type::tfc_item, "Drop values which are not valid items") };
+  };
+};
+
 namespace detail {
 template <typename value_t>
 struct any_filter_decl;
 template <>
 struct any_filter_decl<bool> {
   using value_t = bool;
-  using type = std::variant<filter<filter_e::invert, value_t>, filter<filter_e::timer, value_t, std::chrono::steady_clock>>;
+  using type = std::variant<filter<filter_e::invert, value_t>,
+                            filter<filter_e::timer, value_t, std::chrono::steady_clock>,
+                            filter<filter_e::throttle, value_t, std::chrono::steady_clock>>;
 };
 template <>
 struct any_filter_decl<std::int64_t> {
   using value_t = std::int64_t;
-  using type = std::
-      variant<filter<filter_e::filter_out, value_t>, filter<filter_e::offset, value_t>, filter<filter_e::multiply, value_t>>;
+  using type = std::variant<filter<filter_e::filter_out, value_t>,
+                            filter<filter_e::offset, value_t>,
+                            filter<filter_e::multiply, value_t>,
+                            filter<filter_e::median, value_t>,
+                            filter<filter_e::quantile, value_t>,
+                            filter<filter_e::sliding_window_moving_average, value_t>,
+                            filter<filter_e::exponential_moving_average, value_t>,
+                            filter<filter_e::throttle, value_t, std::chrono::steady_clock>,
+                            filter<filter_e::throttle_average, value_t, std::chrono::steady_clock>,
+                            filter<filter_e::delta, value_t>,
+                            filter<filter_e::calibrate_linear, value_t>,
+                            filter<filter_e::lambda, value_t>>;
 };
 template <>
 struct any_filter_decl<std::uint64_t> {
   using value_t = std::uint64_t;
-  using type = std::
-      variant<filter<filter_e::filter_out, value_t>, filter<filter_e::offset, value_t>, filter<filter_e::multiply, value_t>>;
+  using type = std::variant<filter<filter_e::filter_out, value_t>,
+                            filter<filter_e::offset, value_t>,
+                            filter<filter_e::multiply, value_t>,
+                            filter<filter_e::median, value_t>,
+                            filter<filter_e::quantile, value_t>,
+                            filter<filter_e::sliding_window_moving_average, value_t>,
+                            filter<filter_e::exponential_moving_average, value_t>,
+                            filter<filter_e::throttle, value_t, std::chrono::steady_clock>,
+                            filter<filter_e::throttle_average, value_t, std::chrono::steady_clock>,
+                            filter<filter_e::delta, value_t>,
+                            filter<filter_e::calibrate_linear, value_t>,
+                            filter<filter_e::lambda, value_t>>;
 };
 template <>
 struct any_filter_decl<std::double_t> {
   using value_t = std::double_t;
-  using type = std::
-      variant<filter<filter_e::filter_out, value_t>, filter<filter_e::offset, value_t>, filter<filter_e::multiply, value_t>>;
+  using type = std::variant<filter<filter_e::filter_out, value_t>,
+                            filter<filter_e::offset, value_t>,
+                            filter<filter_e::multiply, value_t>,
+                            filter<filter_e::median, value_t>,
+                            filter<filter_e::quantile, value_t>,
+                            filter<filter_e::sliding_window_moving_average, value_t>,
+                            filter<filter_e::exponential_moving_average, value_t>,
+                            filter<filter_e::throttle, value_t, std::chrono::steady_clock>,
+                            filter<filter_e::throttle_average, value_t, std::chrono::steady_clock>,
+                            filter<filter_e::delta, value_t>,
+                            filter<filter_e::calibrate_linear, value_t>,
+                            filter<filter_e::lambda, value_t>>;
 };
 template <>
 struct any_filter_decl<std::string> {
   using value_t = std::string;
-  using type = std::variant<filter<filter_e::filter_out, value_t>>;
+  using type =
+      std::variant<filter<filter_e::filter_out, value_t>, filter<filter_e::throttle, value_t, std::chrono::steady_clock>>;
 };
-// json?
 template <typename value_t>
 using any_filter_decl_t = any_filter_decl<value_t>::type;
+/// \brief filters of json slots, which hold their values as std::string
+using any_json_filter_decl_t = std::variant<filter<filter_e::filter_out, std::string>,
+                                            filter<filter_e::throttle, std::string, std::chrono::steady_clock>,
+                                            filter<filter_e::json_fields, std::string>,
+                                            filter<filter_e::json_drop, std::string>,
+                                            filter<filter_e::tfc_item, std::string>>;
 }  // namespace detail
 
-template <typename value_t, typename callback_t>
+/// \tparam any_filter_t variant of the filters which can be configured
+template <typename value_t, typename callback_t, typename any_filter_t = detail::any_filter_decl_t<value_t>>
 class filters {
 public:
   filters(asio::io_context& ctx, std::string_view name, callback_t&& callback)
-      : ctx_{ ctx }, filters_{ ctx, fmt::format("{}._filters_", name) }, callback_{ callback } {}
+      : filters(ctx, name, std::forward<callback_t>(callback), ctx.get_executor()) {}
+  /// \param executor the filters are processed on, the strand of the owning slot when it is shared between threads
+  filters(asio::io_context& ctx, std::string_view name, callback_t&& callback, asio::any_io_executor executor)
+      : executor_{ std::move(executor) }, filters_{ ctx, fmt::format("{}._filters_", name) },
+        callback_{ std::move(callback) } {}
+  filters(filters const&) = delete;
+  auto operator=(filters const&) -> filters& = delete;
 
   /// \brief changes internal last_value state when filters have been processed
+  /// A chain of synchronous filters is evaluated inline, only a chain holding a timer style filter spawns a coroutine.
   void operator()(value_t&& value) {
     if (filters_->empty()) {
       last_value_ = std::move(value);
       std::invoke(callback_, last_value_.value());
       return;
     }
+    if (synchronous()) {
+      process_inline(std::move(value));
+      return;
+    }
     std::expected<value_t, std::error_code> return_value{ std::move(value) };
     asio::co_spawn(
-        ctx_,
-        [this, return_val = std::move(return_value)] mutable -> asio::awaitable<std::expected<value_t, std::error_code>> {
+        executor_,
+        [this, alive = std::weak_ptr{ alive_ },
+         return_val = std::move(return_value)] mutable -> asio::awaitable<std::expected<value_t, std::error_code>> {
           for (auto const& filter : filters_.value()) {
             // move the value into the filter and the filter will return the value modified or not
             return_val = co_await std::visit(
@@ -275,6 +1327,10 @@ public:
                   return arg.async_process(std::move(return_v.value()), asio::use_awaitable);  //
                 },
                 filter);
+            if (alive.expired()) {
+              // The filters, and the chain being iterated, were destroyed while the filter waited
+              co_return std::unexpected(std::make_error_code(std::errc::operation_canceled));
+            }
             if (!return_val.has_value()) {
               // The filter has erased the existence of inputted value, exit the coroutine and forget that this happened
               co_return std::move(return_val);
@@ -282,7 +1338,11 @@ public:
           }
           co_return std::move(return_val);
         },
-        [this](std::exception_ptr const& exception_ptr, std::expected<value_t, std::error_code>&& return_val) {
+        [this, alive = std::weak_ptr{ alive_ }](std::exception_ptr const& exception_ptr,
+                                                std::expected<value_t, std::error_code>&& return_val) {
+          if (alive.expired()) {
+            return;
+          }
           if (exception_ptr) {
             std::rethrow_exception(exception_ptr);
           }
@@ -297,10 +1357,50 @@ public:
   [[nodiscard]] auto value() const noexcept -> std::optional<value_t> const& { return last_value_; }
 
 private:
-  asio::io_context& ctx_;
-  tfc::confman::config<std::vector<detail::any_filter_decl_t<value_t>>> filters_;
+  template <typename filter_t>
+  static constexpr bool is_synchronous_v{ detail::synchronous_filter<filter_t, value_t> };
+
+  template <typename>
+  struct all_synchronous;
+  template <typename... filters_t>
+  struct all_synchronous<std::variant<filters_t...>> : std::bool_constant<(is_synchronous_v<filters_t> && ...)> {};
+
+  /// \return true if no filter in the chain needs to wait
+  [[nodiscard]] auto synchronous() const noexcept -> bool {
+    if constexpr (all_synchronous<any_filter_t>::value) {
+      return true;
+    } else {
+      return std::ranges::all_of(filters_.value(), [](any_filter_t const& filter) {
+        return std::visit([]<typename filter_t>(filter_t const&) { return is_synchronous_v<filter_t>; }, filter);
+      });
+    }
+  }
+
+  void process_inline(value_t&& value) {
+    std::expected<value_t, std::error_code> return_val{ std::move(value) };
+    for (auto const& filter : filters_.value()) {
+      return_val = std::visit(
+          [&return_val]<typename filter_t>(filter_t const& arg) -> std::expected<value_t, std::error_code> {
+            if constexpr (is_synchronous_v<filter_t>) {
+              return arg.process(std::move(return_val.value()));
+            } else {
+              return std::unexpected(std::make_error_code(std::errc::operation_not_supported));  // checked by synchronous()
+            }
+          },
+          filter);
+      if (!return_val.has_value()) {
+        return;  // The filter has erased the existence of inputted value
+      }
+    }
+    last_value_ = std::move(return_val.value());
+    std::invoke(callback_, last_value_.value());
+  }
+
+  asio::any_io_executor executor_;
+  tfc::confman::config<std::vector<any_filter_t>> filters_;
   callback_t callback_;
   std::optional<value_t> last_value_{};
+  std::shared_ptr<bool> alive_{ std::make_shared<bool>() };  // spawned chains are dropped once destroyed
 };
 
 }  // namespace tfc::ipc::filter
@@ -317,13 +1417,20 @@ struct glz::meta<tfc::ipc::filter::filter_e> {
                                               "multiply", multiply, "Multiplies each value by a constant value",
                                               "filter_out", filter_out, "Filter out specific values to drop and forget",
                                               "calibrate_linear", calibrate_linear,
-                                              "median", median,
-                                              "quantile", quantile,
+                                              "Least squares line through calibration points",
+                                              "median", median, "Median of a sliding window of values",
+                                              "quantile", quantile, "Quantile of a sliding window of values",
                                               "sliding_window_moving_average", sliding_window_moving_average,
+                                              "Mean of a sliding window of values",
                                               "exponential_moving_average", exponential_moving_average,
-                                              "throttle", throttle,
+                                              "Exponentially weighted mean of the values",
+                                              "throttle", throttle, "Pass on at most one value per period",
                                               "throttle_average", throttle_average,
-                                              "delta", delta,
-                                              "lambda", lambda) };
+                                              "Mean of the values received within each period",
+                                              "delta", delta, "Pass on changes of at least delta only",
+                                              "lambda", lambda, "Expression of the value x",
+                                              "tfc_item", tfc_item, "Drop json values which are not valid items",
+                                              "json_fields", json_fields, "Keep listed top level fields of json objects",
+                                              "json_drop", json_drop, "Drop json objects by the value of a field") };
   // clang-format on
 };
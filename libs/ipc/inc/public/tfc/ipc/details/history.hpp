@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+namespace tfc::ipc::details {
+
+/**
+ * @brief
+ * Latest values of a slot with the time they were received, for trends and fault analysis.
+ * Timestamps and values are kept in separate rings preallocated to the capacity, so recording a value does not
+ * allocate, and a time range is found by binary search over the timestamps only.
+ * @note values are expected to be recorded in time order, a clock stepping back makes older values unreachable
+ * until they are overwritten
+ */
+template <typename value_t, typename clock_type = std::chrono::system_clock>
+class value_history {
+public:
+  using clock = clock_type;
+  using time_point = typename clock_type::time_point;
+
+  /// \brief timestamps[i] is the time of values[i], oldest first
+  struct samples {
+    std::vector<time_point> timestamps{};
+    std::vector<value_t> values{};
+  };
+
+  value_history() = default;
+  explicit value_history(std::size_t capacity) { reset(capacity); }
+
+  /// \brief forget every value and make room for capacity values
+  void reset(std::size_t capacity) {
+    timestamps_.assign(capacity, time_point{});
+    values_.assign(capacity, value_t{});
+    head_ = 0;
+    size_ = 0;
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return timestamps_.size(); }
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+
+  /// \brief overwrite the oldest value once full, does nothing if the capacity is zero
+  void record(time_point timestamp, value_t const& value) {
+    if (timestamps_.empty()) {
+      return;
+    }
+    timestamps_[head_] = timestamp;
+    values_[head_] = value;  // assigning keeps the capacity of strings in the ring
+    head_ = head_ + 1 == timestamps_.size() ? 0 : head_ + 1;
+    size_ = std::min(size_ + 1, timestamps_.size());
+  }
+
+  /// \return every value recorded in [from, to]
+  [[nodiscard]] auto history(time_point from, time_point to) const -> samples { return history(from, to, 0); }
+
+  /**
+   * @return values recorded in [from, to], at most max_points of them, zero for all of them
+   * The range is split in equal buckets. Numbers keep the lowest and highest value of each bucket so peaks survive the
+   * downsampling, other types and a max_points of one keep the latest value of each bucket.
+   */
+  [[nodiscard]] auto history(time_point from, time_point to, std::size_t max_points) const -> samples {
+    auto const [first, last]{ find(from, to) };
+    auto const count{ last - first };
+    samples result{};
+    if (max_points == 0 || count <= max_points) {
+      result.timestamps.reserve(count);
+      result.values.reserve(count);
+      for (auto idx{ first }; idx < last; idx++) {
+        append(result, idx);
+      }
+      return result;
+    }
+    static constexpr bool numeric{ std::is_arithmetic_v<value_t> && !std::is_same_v<value_t, bool> };
+    bool const extremes{ numeric && max_points >= 2 };
+    std::size_t const buckets{ extremes ? max_points / 2 : max_points };
+    result.timestamps.reserve(max_points);
+    result.values.reserve(max_points);
+    for (std::size_t bucket{ 0 }; bucket < buckets; bucket++) {
+      auto const begin{ first + count * bucket / buckets };
+      auto const end{ first + count * (bucket + 1) / buckets };
+      if constexpr (numeric) {
+        if (!extremes) {
+          append(result, end - 1);
+          continue;
+        }
+        auto lowest{ begin };
+        auto highest{ begin };
+        for (auto idx{ begin + 1 }; idx < end; idx++) {
+          lowest = value_at(idx) < value_at(lowest) ? idx : lowest;
+          highest = value_at(highest) < value_at(idx) ? idx : highest;
+        }
+        append(result, std::min(lowest, highest));
+        if (lowest != highest) {
+          append(result, std::max(lowest, highest));
+        }
+      } else {
+        append(result, end - 1);
+      }
+    }
+    return result;
+  }
+
+private:
+  /// \param idx zero for the oldest value
+  [[nodiscard]] auto physical(std::size_t idx) const noexcept -> std::size_t {
+    auto const oldest{ size_ == timestamps_.size() ? head_ : 0 };
+    auto const position{ oldest + idx };
+    return position < timestamps_.size() ? position : position - timestamps_.size();
+  }
+  [[nodiscard]] auto time_at(std::size_t idx) const noexcept -> time_point const& { return timestamps_[physical(idx)]; }
+  // decltype(auto) as std::vector<bool> yields bool by value, value_t const& would refer to a temporary
+  [[nodiscard]] auto value_at(std::size_t idx) const noexcept -> decltype(auto) { return values_[physical(idx)]; }
+
+  void append(samples& result, std::size_t idx) const {
+    result.timestamps.emplace_back(time_at(idx));
+    result.values.emplace_back(value_at(idx));
+  }
+
+  struct range {
+    std::size_t first{};
+    std::size_t last{};
+  };
+
+  /// \return indexes of the values recorded in [from, to]
+  [[nodiscard]] auto find(time_point from, time_point to) const -> range {
+    if (to < from) {
+      return {};
+    }
+    auto const indexes{ std::views::iota(std::size_t{ 0 }, size_) };
+    // the partition point is the end of indexes when every value is before the bound, which may not be dereferenced
+    auto const index_of{ [&indexes](auto const& iter) {
+      return static_cast<std::size_t>(std::ranges::distance(indexes.begin(), iter));
+    } };
+    auto const first{ index_of(
+        std::ranges::partition_point(indexes, [this, from](auto idx) { return time_at(idx) < from; })) };
+    auto const last{ index_of(
+        std::ranges::partition_point(indexes, [this, to](auto idx) { return !(to < time_at(idx)); })) };
+    return { .first = first, .last = std::max(first, last) };
+  }
+
+  std::vector<time_point> timestamps_{};
+  std::vector<value_t> values_{};
+  std::size_t head_{};
+  std::size_t size_{};
+};
+
+}  // namespace tfc::ipc::details
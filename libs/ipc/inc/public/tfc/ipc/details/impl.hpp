@@ -1,29 +1,43 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cassert>
 #include <concepts>
 #include <expected>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <variant>
 
+#include <unistd.h>
+
 #include <fmt/format.h>
 #include <azmq/socket.hpp>
+#include <boost/asio/bind_executor.hpp>
 #include <boost/asio/compose.hpp>
+#include <boost/asio/dispatch.hpp>
 #include <boost/asio/io_context.hpp>
-#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <tfc/ipc/batch.hpp>
 #include <tfc/ipc/details/dbus_slot.hpp>
 #include <tfc/ipc/details/filter.hpp>
+#include <tfc/ipc/details/shm.hpp>
+#include <tfc/ipc/details/statistics.hpp>
+#include <tfc/ipc/details/strand.hpp>
 #include <tfc/ipc/details/type_description.hpp>
 #include <tfc/ipc/enums.hpp>
 #include <tfc/ipc/packet.hpp>
 #include <tfc/progbase.hpp>
 #include <tfc/stx/concepts.hpp>
+#include <tfc/stx/small_function.hpp>
 #include <tfc/utils/pragmas.hpp>
 #include <tfc/utils/socket.hpp>
 
@@ -36,6 +50,20 @@ enum struct ipc_errors_e {
   inconsistent_size = 2,
 };
 
+/// \brief First byte of a snapshot topic frame.
+/// Every slot subscribes to a topic unique to itself, when the signal sees that subscription it publishes its last value
+/// prefixed with the topic so only the joining slot receives it. Value messages start with the protocol version and
+/// never collide with this prefix. Topics end with snapshot_topic_terminator, zmq matches subscriptions by prefix and
+/// the topic of one slot must not be the prefix of another's.
+static constexpr std::byte snapshot_topic_prefix{ 0xff };
+static constexpr char snapshot_topic_terminator{ '|' };
+
+/// \brief How a slot treats values which have queued up while it was busy
+enum struct receive_policy_e : std::uint8_t {
+  all = 0,     // every value is delivered in order
+  latest = 1,  // only the newest pending value is delivered, intermediate values are dropped
+};
+
 /**@brief
  * Base class for signal and slot. Contains naming
  * and shared ptr factory constructors.
@@ -44,6 +72,8 @@ template <typename type_desc>
 class transmission_base {
 public:
   explicit transmission_base(std::string_view name) : name_(name) {}
+  /// \param owner <exe>.<proc> to name the transmission after instead of this process
+  transmission_base(std::string_view owner, std::string_view name) : name_(name), owner_(owner) {}
 
   [[nodiscard]] auto endpoint() const -> std::string { return utils::socket::zmq::ipc_endpoint_str(name_w_type()); }
 
@@ -51,6 +81,9 @@ public:
 
   /// \return <type>.<name>
   [[nodiscard]] auto name_w_type() const -> std::string {
+    if (!owner_.empty()) {
+      return fmt::format("{}.{}.{}", owner_, type_desc::type_name, name_);
+    }
     return fmt::format("{}.{}.{}.{}", base::get_exe_name(), base::get_proc_name(), type_desc::type_name, name_);
   }
 
@@ -58,10 +91,14 @@ public:
 
 private:
   std::string name_;  // name of signal/slot
+  std::string owner_{};
 };
 
 /**@brief
  * Signal publishing class.
+ * Thread safety: a signal created from an io_context is single threaded, it and its io_context are to be used from one
+ * thread only. A signal created from a strand runs all of its handlers on that strand, async_send may then be called
+ * from any thread while send and enable_crc are to be called from within the strand, see executor().
  * */
 template <typename type_desc>
 class signal : public transmission_base<type_desc>, public std::enable_shared_from_this<signal<type_desc>> {
@@ -70,125 +107,314 @@ public:
   using packet_t = packet<value_t, type_desc::value_e>;
   static auto constexpr direction_v = direction_e::signal;
 
-  [[nodiscard]] static auto create(asio::io_context& ctx, std::string_view name)
+  /// \param transport transport_e::shm additionally publishes over shared memory to slots on the same host
+  [[nodiscard]] static auto create(asio::io_context& ctx, std::string_view name, transport_e transport = transport_e::zmq)
+      -> std::expected<std::shared_ptr<signal<type_desc>>, std::error_code> {
+    auto ptr = std::shared_ptr<signal<type_desc>>(new signal(ctx, name, std::nullopt));
+    auto error = ptr->init(transport);
+    if (error) {
+      return std::unexpected(error);
+    }
+    return ptr;
+  }
+
+  /// \param owner <exe>.<proc> the signal is published as, lets a bridge re-publish a remote signal under its original name
+  [[nodiscard]] static auto create(asio::io_context& ctx,
+                                   std::string_view owner,
+                                   std::string_view name,
+                                   transport_e transport = transport_e::zmq)
+      -> std::expected<std::shared_ptr<signal<type_desc>>, std::error_code> {
+    auto ptr = std::shared_ptr<signal<type_desc>>(new signal(ctx, owner, name));
+    auto error = ptr->init(transport);
+    if (error) {
+      return std::unexpected(error);
+    }
+    return ptr;
+  }
+
+  /// \param strand the signal runs its handlers on, makes async_send safe to call from any thread
+  [[nodiscard]] static auto create(strand_t const& strand, std::string_view name, transport_e transport = transport_e::zmq)
       -> std::expected<std::shared_ptr<signal<type_desc>>, std::error_code> {
-    auto ptr = std::shared_ptr<signal<type_desc>>(new signal(ctx, name));
-    auto error = ptr->init();
+    auto ptr = std::shared_ptr<signal<type_desc>>(new signal(strand.get_inner_executor().context(), name, strand));
+    auto error = ptr->init(transport);
     if (error) {
       return std::unexpected(error);
     }
     return ptr;
   }
+
+  /// \return the strand of the signal, or the executor of its io_context if it is single threaded
+  [[nodiscard]] auto executor() const -> asio::any_io_executor {
+    if (strand_) {
+      return strand_.value();
+    }
+    return socket_.get_io_context().get_executor();
+  }
   /// @brief send value to subscriber
   /// @param value is sent
   /// @return std::error_code, empty if no error.
+  /// @note needs to be called from within the strand of the signal, if it has one
   auto send(value_t const& value) -> std::error_code {
+    assert((!strand_ || strand_->running_in_this_thread()) && "send called from outside the strand of the signal");
     last_value_ = value;
-    std::vector<std::byte> send_buffer{};
-    if (auto serialize_err{ packet_t::serialize(last_value_, send_buffer) }) {
-      return serialize_err;
-    }
-    std::size_t size = socket_.send(asio::buffer(send_buffer));
-    if (size != send_buffer.size()) {
+    // header is written to the preallocated header buffer, payload is sent straight from last_value_
+    auto const buffers{ packet_t::serialize(last_value_, header_buffer_, next_header()) };
+    auto const shm_error{ publish_shm(buffers) };
+    std::size_t size = socket_.send(to_const_buffers(buffers));
+    if (size != buffers[0].size() + buffers[1].size()) {
       return std::make_error_code(std::errc::value_too_large);
     }
-    return {};
+    return shm_error;
   }
 
   /// @brief send value to subscriber
   /// @tparam completion_token_t a concept of type void(std::error_code, std::size_t)
   /// @param value is sent
+  /// @note within an open tfc::ipc::batch the value is sent when the batch closes, a send superseded by a later one
+  /// within the same batch completes with std::errc::operation_canceled
+  /// @note safe to call from any thread if the signal has a strand, the value is then copied over to the strand
   template <typename completion_token_t>
   auto async_send(value_t const& value, completion_token_t&& token)
       -> asio::async_result<std::decay_t<completion_token_t>, void(std::error_code, std::size_t)>::return_type {
+    if (strand_ && !strand_->running_in_this_thread()) {
+      return async_send_through_strand(value, std::forward<completion_token_t>(token));
+    }
     last_value_ = value;
-    std::unique_ptr<std::vector<std::byte>> send_buffer{ std::make_unique<std::vector<std::byte>>() };
-    if (auto serialize_error{ packet_t::serialize(last_value_, *send_buffer) }) {
-      return asio::async_compose<completion_token_t, void(std::error_code, std::size_t)>(
-          [serialize_error](auto& self, std::error_code = {}, std::size_t = 0) { self.complete(serialize_error, 0); },
-          token);
+    if (auto* active{ batch::current() }) {
+      return async_send_batched(*active, std::forward<completion_token_t>(token));
     }
+    // The frame keeps its own copy of the value alive until the send completes, frames are recycled
+    // so a steady stream of sends reuses both the frame and the capacity of its value.
+    auto frame{ acquire_frame() };
+    frame->value = value;
+    auto const buffers{ packet_t::serialize(frame->value, frame->header, next_header()) };
+    auto const shm_error{ publish_shm(buffers) };
 
     enum struct state_e { write, complete };
 
     auto& socket{ socket_ };
     return asio::async_compose<completion_token_t, void(std::error_code, std::size_t)>(
-        [&socket, buffer = std::move(send_buffer), state = state_e::write](auto& self, std::error_code err = {},
-                                                                           std::size_t bytes_sent = 0) mutable {
-          if (err) {
-            self.complete(err, bytes_sent);
+        [&socket, frame = std::move(frame), buffers = to_const_buffers(buffers), state = state_e::write, shm_error,
+         owner = std::enable_shared_from_this<signal<type_desc>>::weak_from_this()](
+            auto& self, std::error_code err = {}, std::size_t bytes_sent = 0) mutable {
+          if (!err && state == state_e::write) {
+            state = state_e::complete;
+            auto instance = owner.lock();
+            if (!instance) {
+              self.complete(std::make_error_code(std::errc::operation_canceled), 0);
+              return;
+            }
+            auto const initiation{ [&socket, &buffers](auto&& handler) {
+              azmq::async_send(socket, buffers, std::forward<decltype(handler)>(handler));
+            } };
+            initiate_on(instance->strand_, initiation, std::move(self));
             return;
           }
+          if (auto instance = owner.lock()) {
+            instance->release_frame(std::move(frame));
+          }
+          // the zmq slots got the value, the error of the shared memory slots is reported otherwise
+          self.complete(err ? err : shm_error, bytes_sent);
+        },
+        token, socket_);
+  }
+
+  /// \brief append a crc32 of the value to each header, verified by the receiving slots
+  void enable_crc(bool enable) noexcept { crc_ = enable; }
+
+private:
+  signal(asio::io_context& ctx, std::string_view name, std::optional<strand_t> strand)
+      : transmission_base<type_desc>(name), last_value_(), socket_(ctx), strand_{ std::move(strand) } {}
+  signal(asio::io_context& ctx, std::string_view owner, std::string_view name)
+      : transmission_base<type_desc>(owner, name), last_value_(), socket_(ctx) {}
+
+  /// \brief copy the value and send it from within the strand
+  template <typename completion_token_t>
+  auto async_send_through_strand(value_t const& value, completion_token_t&& token)
+      -> asio::async_result<std::decay_t<completion_token_t>, void(std::error_code, std::size_t)>::return_type {
+    enum struct state_e { dispatch, send, complete };
+
+    return asio::async_compose<completion_token_t, void(std::error_code, std::size_t)>(
+        [copy = value, state = state_e::dispatch, owner = std::enable_shared_from_this<signal<type_desc>>::weak_from_this(),
+         strand = strand_.value()](auto& self, std::error_code err = {}, std::size_t bytes_sent = 0) mutable {
           switch (state) {
-            case state_e::write: {
+            case state_e::dispatch:
+              state = state_e::send;
+              asio::dispatch(strand, std::move(self));
+              return;
+            case state_e::send:
               state = state_e::complete;
-              azmq::async_send(socket, asio::buffer(*buffer), std::move(self));
-              break;
-            }
-            case state_e::complete: {
+              if (auto instance = owner.lock()) {
+                instance->async_send(copy, std::move(self));
+                return;
+              }
+              self.complete(std::make_error_code(std::errc::operation_canceled), 0);
+              return;
+            case state_e::complete:
               self.complete(err, bytes_sent);
-              break;
-            }
+              return;
           }
         },
         token, socket_);
   }
 
-private:
-  signal(asio::io_context& ctx, std::string_view name)
-      : transmission_base<type_desc>(name), last_value_(), timer_(ctx), socket_(ctx),
-        socket_monitor_(socket_.monitor(ctx, ZMQ_EVENT_HANDSHAKE_SUCCEEDED)) {}
-
-  auto init() -> std::error_code {
+  auto init(transport_e transport) -> std::error_code {
     boost::system::error_code error_code;
     socket_.bind(this->endpoint(), error_code);
     if (error_code) {
       return error_code;
     }
-    register_handle_accept();
+    if (transport == transport_e::shm) {
+      auto shm_publisher{
+        shm::publisher::create(socket_.get_io_context(), this->name_w_type(), shm::default_capacity, strand_)
+      };
+      if (!shm_publisher) {
+        return shm_publisher.error();
+      }
+      shm_ = std::move(shm_publisher.value());
+    }
+    register_handle_subscription();
     return {};
   }
 
-  void handle_event_accept(std::error_code const& error_code, azmq::message&, size_t) {
+  /// \return header of the next value to send, stamped with the current time
+  auto next_header() noexcept -> header_t<type_desc::value_e> {
+    return { .timestamp = monotonic_ns(),
+             .sequence = ++sequence_,
+             .flags = crc_ ? header_flags_e::crc : header_flags_e::none };
+  }
+
+  auto buffers_size() const noexcept -> std::size_t { return packet_t::header_size + packet_t::payload(last_value_).size(); }
+
+  // Shared memory slots always see the latest value, zmq remains the transport for everyone else
+  // The segment grows to fit the value, an error means it could not be grown and the shared memory slots missed it
+  auto publish_shm(typename packet_t::buffer_sequence_t const& buffers) -> std::error_code {
+    if (shm_) {
+      return shm_->publish(buffers);
+    }
+    return {};
+  }
+
+  /// \brief header and payload are sent as a two part zmq message
+  static auto to_const_buffers(typename packet_t::buffer_sequence_t const& buffers) -> std::array<asio::const_buffer, 2> {
+    return { asio::const_buffer{ buffers[0].data(), buffers[0].size() },
+             asio::const_buffer{ buffers[1].data(), buffers[1].size() } };
+  }
+
+  /// \brief storage of an in flight async_send
+  struct send_frame {
+    typename packet_t::header_buffer_t header{};
+    value_t value{};
+  };
+
+  auto acquire_frame() -> std::unique_ptr<send_frame> {
+    if (free_frames_.empty()) {
+      return std::make_unique<send_frame>();
+    }
+    auto frame{ std::move(free_frames_.back()) };
+    free_frames_.pop_back();
+    return frame;
+  }
+
+  void release_frame(std::unique_ptr<send_frame>&& frame) { free_frames_.emplace_back(std::move(frame)); }
+
+  /// \brief publish last_value_ once when the batch closes and complete after that
+  /// Only the last send of the batch reports the result of publishing, the value of the others is never published.
+  template <typename completion_token_t>
+  auto async_send_batched(batch& active, completion_token_t&& token)
+      -> asio::async_result<std::decay_t<completion_token_t>, void(std::error_code, std::size_t)>::return_type {
+    auto const sequence{ ++batch_sequence_ };
+    if (!batch_pending_) {
+      batch_pending_ = true;
+      active.enqueue(std::enable_shared_from_this<signal<type_desc>>::weak_from_this(),
+                     [](void* instance) { static_cast<signal*>(instance)->flush_batched(); });
+    }
+
+    enum struct state_e { wait, complete };
+
+    return asio::async_compose<completion_token_t, void(std::error_code, std::size_t)>(
+        [&flushed = active.flushed(), state = state_e::wait, sequence,
+         owner = std::enable_shared_from_this<signal<type_desc>>::weak_from_this()](auto& self, std::error_code = {},
+                                                                                    std::size_t = 0) mutable {
+          if (state == state_e::wait) {
+            state = state_e::complete;
+            flushed.async_wait(std::move(self));
+            return;
+          }
+          // the timer is cancelled by the flush, its error code carries no information
+          if (auto instance = owner.lock(); instance && sequence == instance->batch_flushed_sequence_) {
+            self.complete(instance->batch_error_, instance->batch_bytes_);
+            return;
+          }
+          // superseded within the batch, or the signal is gone
+          self.complete(std::make_error_code(std::errc::operation_canceled), 0);
+        },
+        token, socket_);
+  }
+
+  void flush_batched() {
+    batch_pending_ = false;
+    batch_flushed_sequence_ = batch_sequence_;
+    batch_error_ = send(last_value_);
+    batch_bytes_ = batch_error_ ? 0 : buffers_size();
+  }
+
+  /// \brief publish the last value to a slot which has just subscribed to its snapshot topic
+  void handle_subscription(std::error_code const& error_code, std::size_t bytes_received) {
     if (error_code) {
-      assert(false && "Handle event accept canceled!");
+      assert(false && "Handle subscription canceled!");
       return;
     }
-    std::array<std::byte, 1024> buffer;
-    socket_monitor_.receive(asio::buffer(buffer), 0);
-    // TODO: This sleep is the worst.
-    timer_.expires_after(std::chrono::milliseconds(1));
-    timer_.async_wait([this](std::error_code const& error) {
-      if (error) {
-        return;
-      }
-      async_send(last_value_, [&](std::error_code err, size_t) {
-        if (err) {
-          assert(false && "Handle event accept (send) canceled!");
-          return;
-        }
-        register_handle_accept();
-      });
-    });
+    // Subscription messages are a subscribe(1)/unsubscribe(0) byte followed by the topic
+    std::span<std::byte const> const message{ subscription_buffer_.data(),
+                                              std::min(bytes_received, subscription_buffer_.size()) };
+    // nothing to snapshot before the first value has been sent, the joining slot waits for it
+    if (sequence_ != 0 && message.size() > 1 && message[0] == std::byte{ 1 } && message[1] == snapshot_topic_prefix) {
+      auto const topic{ message.subspan(1) };
+      // the snapshot repeats the sequence number of the last value sent
+      header_t<type_desc::value_e> const header{ .timestamp = monotonic_ns(),
+                                                 .sequence = sequence_,
+                                                 .flags = crc_ ? header_flags_e::crc : header_flags_e::none };
+      auto const buffers{ packet_t::serialize(last_value_, header_buffer_, header) };
+      std::array<asio::const_buffer, 3> const snapshot{ asio::const_buffer{ topic.data(), topic.size() },
+                                                        asio::const_buffer{ buffers[0].data(), buffers[0].size() },
+                                                        asio::const_buffer{ buffers[1].data(), buffers[1].size() } };
+      boost::system::error_code send_error;
+      socket_.send(snapshot, 0, send_error);
+    }
+    register_handle_subscription();
   }
 
-  void register_handle_accept() {
+  void register_handle_subscription() {
     auto bind_reference = std::enable_shared_from_this<signal<type_desc>>::weak_from_this();
-    socket_monitor_.async_receive(
-        [bind_reference](std::error_code const& error_code, azmq::message& msg, size_t bytes_received) {
+    initiate_on(
+        strand_, [this](auto&& handler) { socket_.async_receive(asio::buffer(subscription_buffer_), std::move(handler)); },
+        [bind_reference](std::error_code const& error_code, std::size_t bytes_received) {
           if (auto instance = bind_reference.lock()) {
-            instance->handle_event_accept(error_code, msg, bytes_received);
+            instance->handle_subscription(error_code, bytes_received);
           }
         });
   }
   value_t last_value_{};
-  boost::asio::steady_timer timer_;
-  azmq::pub_socket socket_;
-  azmq::socket socket_monitor_;
+  typename packet_t::header_buffer_t header_buffer_{};
+  std::vector<std::unique_ptr<send_frame>> free_frames_{};
+  std::array<std::byte, 256> subscription_buffer_{};
+  std::uint64_t sequence_{};  // of the last value sent, 0 until the first one
+  bool crc_{ false };
+  bool batch_pending_{ false };
+  std::uint64_t batch_sequence_{};          // of the last batched send
+  std::uint64_t batch_flushed_sequence_{};  // of the send whose value the last flush published
+  std::error_code batch_error_{};
+  std::size_t batch_bytes_{};
+  azmq::xpub_socket socket_;
+  std::optional<strand_t> strand_{};
+  std::unique_ptr<shm::publisher> shm_{};
 };
 
 /**@brief slot
- *
+ * Thread safety: like signal, a slot created from an io_context is to be used from the thread running it. A slot
+ * created from a strand completes its receive operations on the strand, connect, disconnect and the receive operations
+ * are to be initiated from within the strand, see executor().
  * */
 template <typename type_desc>
 class slot : public transmission_base<type_desc> {
@@ -198,23 +424,64 @@ public:
   using packet_t = packet<value_t, value_e>;
   static auto constexpr direction_v = direction_e::slot;
 
-  [[nodiscard]] static auto create(asio::io_context& ctx, std::string_view name) -> std::shared_ptr<slot<type_desc>> {
-    return std::shared_ptr<slot<type_desc>>(new slot(ctx, name));
+  [[nodiscard]] static auto create(asio::io_context& ctx,
+                                   std::string_view name,
+                                   receive_policy_e policy = receive_policy_e::all) -> std::shared_ptr<slot<type_desc>> {
+    return std::shared_ptr<slot<type_desc>>(new slot(ctx, name, policy));
+  }
+  /// \param strand the slot completes its receive operations on
+  [[nodiscard]] static auto create(strand_t const& strand,
+                                   std::string_view name,
+                                   receive_policy_e policy = receive_policy_e::all) -> std::shared_ptr<slot<type_desc>> {
+    return std::shared_ptr<slot<type_desc>>(new slot(strand, name, policy));
+  }
+  /// \param policy receive_policy_e::latest conflates queued values, it also lets the slot receive over shared memory
+  /// from a signal which publishes over it, see transport_e::shm
+  slot(asio::io_context& ctx, std::string_view name, receive_policy_e policy = receive_policy_e::all)
+      : transmission_base<type_desc>(name), socket_(ctx), policy_{ policy }, snapshot_topic_{ make_snapshot_topic() } {}
+  slot(strand_t const& strand, std::string_view name, receive_policy_e policy = receive_policy_e::all)
+      : slot(strand.get_inner_executor().context(), name, policy) {
+    strand_ = strand;
+  }
+
+  /// \return the strand of the slot, or the executor of its io_context if it is single threaded
+  [[nodiscard]] auto executor() const -> asio::any_io_executor {
+    if (strand_) {
+      return strand_.value();
+    }
+    return socket_.get_io_context().get_executor();
   }
-  slot(asio::io_context& ctx, std::string_view name) : transmission_base<type_desc>(name), socket_(ctx) {}
   /**
    * @brief
    * connect to the signal indicated by name
    * */
   auto connect(std::string_view signal_name) -> std::error_code {
+    assert((!strand_ || strand_->running_in_this_thread()) && "connect called from outside the strand of the slot");
     // TODO: Find out if these mutexes inside optimize single threaded are really needed
     socket_ = azmq::sub_socket(socket_.get_io_context(), true);
+    shm_.reset();
+    // Shared memory only holds the latest value, a slot receiving every value stays on zmq.
+    // A latest value slot prefers shared memory if the signal publishes over it, otherwise it falls back to zmq.
+    if (policy_ == receive_policy_e::latest) {
+      if (auto shm_subscription{ shm::subscription::connect(socket_.get_io_context(), signal_name) }) {
+        shm_ = std::move(shm_subscription.value());
+        return {};
+      }
+    }
     boost::system::error_code error_code;
     std::string const socket_path{ utils::socket::zmq::ipc_endpoint_str(signal_name) };
     if (socket_.connect(socket_path, error_code)) {
       return error_code;
     }
-    if (socket_.set_option(azmq::socket::subscribe(""), error_code)) {
+    // Values start with the protocol version, subscribing to them rather than everything filters out snapshots of others
+    for (auto const version : { version_e::v0, version_e::v1 }) {
+      std::array<char, 1> const value_topic{ static_cast<char>(version) };
+      if (socket_.set_option(azmq::socket::subscribe(value_topic.data(), value_topic.size()), error_code)) {
+        return error_code;
+      }
+    }
+    // The signal answers this subscription with its current value, once per connect
+    if (socket_.set_option(azmq::socket::subscribe(snapshot_topic_), error_code)) {
       return error_code;
     }
     return {};
@@ -222,18 +489,24 @@ public:
 
   /**
    * @brief synchronous reception of slot data.
+   * @note over shared memory the latest value is returned without waiting for a new one
    * @return a new value sent to the slot
    */
-  [[nodiscard]] auto receive() -> std::expected<value_t&, std::error_code> {
-    std::array<std::byte, 1024> buffer;
+  [[nodiscard]] auto receive() -> std::expected<value_t, std::error_code> {
+    value_t value{};
+    if (shm_) {
+      if (auto err{ read_shm(value) }) {
+        return std::unexpected(err);
+      }
+      return value;
+    }
+    azmq::message header_message{};
     boost::system::error_code code;
-    auto bytes_received = socket_.receive(buffer, 0, code);
-
-    if (bytes_received < packet_t::header_size()) {
-      return std::unexpected(ipc_errors_e::message_to_small);
+    socket_.receive(header_message, 0, code);
+    if (auto err{ receive_value(value, code, header_message) }) {
+      return std::unexpected(err);
     }
-
-    return packet_t::deserialize(std::span(buffer.data(), bytes_received)).value;
+    return value;
   }
 
   /// \brief schedule an async_read on the slot
@@ -246,14 +519,8 @@ public:
       -> asio::async_result<std::decay_t<completion_token_t>, void(std::expected<value_t, std::error_code>)>::return_type {
     enum struct state_e { read, complete };
 
-    std::unique_ptr<std::vector<std::byte>> receive_buffer{ std::make_unique<std::vector<std::byte>>() };
-    receive_buffer->resize(4096, {});
-    // todo receive header first then value
-
-    azmq::sub_socket& socket{ socket_ };
     return asio::async_compose<completion_token_t, void(std::expected<value_t, std::error_code>)>(
-        [&socket, state = state_e::read, buffer = std::move(receive_buffer)](auto& self, std::error_code err = {},
-                                                                             std::size_t bytes_received = 0) mutable {
+        [this, state = state_e::read](auto& self, std::error_code err = {}) mutable {
           if (err) {
             self.complete(std::unexpected(err));
             return;
@@ -261,11 +528,11 @@ public:
           switch (state) {
             case state_e::read: {
               state = state_e::complete;
-              azmq::async_receive(socket, asio::buffer(*buffer), std::move(self));
+              async_receive_into(receive_value_, std::move(self));
               break;
             }
             case state_e::complete: {
-              self.complete(packet_t::deserialize(std::span{ buffer->data(), bytes_received }));
+              self.complete(std::move(receive_value_));
               break;
             }
           }
@@ -273,16 +540,169 @@ public:
         token, socket_);
   }
 
+  /// \brief schedule an async_read on the slot which deserializes into the given value
+  /// The header is received first and the value is sized from its value_size, so messages of any size are received
+  /// and a string or json value received into repeatedly reuses its capacity.
+  /// \param value destination, needs to outlive the operation
+  /// \tparam completion_token_t completion token in asio format with signature void(std::error_code)
+  template <typename completion_token_t>
+  auto async_receive_into(value_t& value, completion_token_t&& token)
+      -> asio::async_result<std::decay_t<completion_token_t>, void(std::error_code)>::return_type {
+    if (shm_) {
+      return async_receive_shm(value, std::forward<completion_token_t>(token));
+    }
+    return asio::async_compose<completion_token_t, void(std::error_code)>(
+        [this, &value](auto& self, auto&&... args) {
+          if constexpr (sizeof...(args) == 0) {
+            // the header part of the message
+            initiate_on(
+                strand_, [this](auto&& handler) { socket_.async_receive(std::forward<decltype(handler)>(handler)); },
+                std::move(self));
+          } else {
+            self.complete(receive_value(value, std::forward<decltype(args)>(args)...));
+          }
+        },
+        token, socket_);
+  }
+
   /**
    * @brief disconnect from signal
    */
   auto disconnect(std::string_view signal_name) {
+    shm_.reset();
     [[maybe_unused]] boost::system::error_code code;
     return socket_.disconnect(signal_name.data(), code);
   }
 
+  /// \return true if connected to the signal over shared memory
+  [[nodiscard]] auto is_shm() const noexcept -> bool { return static_cast<bool>(shm_); }
+
+  /// \return latency and loss of the values received so far
+  [[nodiscard]] auto statistics() const noexcept -> receive_statistics const& { return statistics_; }
+
+  /// \return header of the last value received
+  [[nodiscard]] auto last_header() const noexcept -> header_t<value_e> const& { return header_; }
+
 private:
+  static auto bytes(azmq::message const& message) noexcept -> std::span<std::byte const> {
+    return { static_cast<std::byte const*>(message.data()), message.size() };
+  }
+
+  /// \brief receive the value part of a message whose header part has been received
+  auto receive_value(value_t& value,
+                     boost::system::error_code const& err,
+                     azmq::message& header_message,
+                     std::size_t = 0) -> std::error_code {
+    if (err) {
+      return err;
+    }
+    if (auto receive_err{ receive_parts(header_message, value_message_) }) {
+      return receive_err;
+    }
+    if (policy_ == receive_policy_e::latest) {
+      // Drain everything queued up and only deserialize the newest message
+      for (;;) {
+        boost::system::error_code drain_err;
+        socket_.receive(latest_header_message_, ZMQ_DONTWAIT, drain_err);
+        if (drain_err || receive_parts(latest_header_message_, latest_value_message_)) {
+          break;  // would block, nothing newer is queued
+        }
+        std::swap(header_message, latest_header_message_);
+        std::swap(value_message_, latest_value_message_);
+      }
+    }
+    return deserialize(value, bytes(header_message), bytes(value_message_));
+  }
+
+  /// \brief deserialize and account for the received value in statistics_
+  auto deserialize(value_t& value, auto&&... buffers) -> std::error_code {
+    if (auto err{ packet_t::deserialize_into(value, header_, buffers...) }) {
+      statistics_.errors++;
+      return err;
+    }
+    statistics_.record(header_, monotonic_ns(), shm_ || policy_ == receive_policy_e::latest);
+    return {};
+  }
+
+  /// \brief receive the rest of a message whose header part has been received
+  /// A snapshot is prefixed with its topic frame, in which case the header is the following part.
+  auto receive_parts(azmq::message& header_message, azmq::message& value_message) -> std::error_code {
+    if (!header_message.more()) {
+      return std::make_error_code(std::errc::message_size);
+    }
+    // A multipart message is delivered atomically, the remaining parts are already queued
+    boost::system::error_code receive_err;
+    if (auto const first{ bytes(header_message) }; !first.empty() && first[0] == snapshot_topic_prefix) {
+      socket_.receive(header_message, ZMQ_DONTWAIT, receive_err);
+      if (receive_err) {
+        return receive_err;
+      }
+      if (!header_message.more()) {
+        return std::make_error_code(std::errc::message_size);
+      }
+    }
+    socket_.receive(value_message, ZMQ_DONTWAIT, receive_err);
+    if (receive_err) {
+      return receive_err;
+    }
+    // discard trailing parts this protocol version does not know of
+    azmq::message trailing{};
+    bool more{ value_message.more() };
+    while (more) {
+      socket_.receive(trailing, ZMQ_DONTWAIT, receive_err);
+      more = !receive_err && trailing.more();
+    }
+    return {};
+  }
+
+  /// \return topic unique to this slot instance within the host
+  static auto make_snapshot_topic() -> std::string {
+    static std::atomic<std::uint64_t> counter{};
+    return fmt::format("{}{}.{}{}", static_cast<char>(snapshot_topic_prefix), getpid(), counter.fetch_add(1),
+                       snapshot_topic_terminator);
+  }
+
+  auto read_shm(value_t& value) -> std::error_code {
+    if (auto err{ shm_->read(shm_buffer_) }) {
+      return err;
+    }
+    return deserialize(value, std::span<std::byte const>{ shm_buffer_ });
+  }
+
+  /// \brief receive the latest value from shared memory, waits for a notification if it has already been read
+  template <typename completion_token_t>
+  auto async_receive_shm(value_t& value, completion_token_t&& token)
+      -> asio::async_result<std::decay_t<completion_token_t>, void(std::error_code)>::return_type {
+    return asio::async_compose<completion_token_t, void(std::error_code)>(
+        [this, &value](auto& self, std::error_code err = {}) {
+          if (err) {
+            self.complete(err);
+            return;
+          }
+          // A torn read is retried on the next notification
+          if (shm_->has_pending() && !read_shm(value)) {
+            self.complete({});
+            return;
+          }
+          initiate_on(
+              strand_, [this](auto&& handler) { shm_->async_wait(std::forward<decltype(handler)>(handler)); },
+              std::move(self));
+        },
+        token, socket_);
+  }
+
   azmq::sub_socket socket_;
+  std::optional<strand_t> strand_{};
+  receive_policy_e policy_{ receive_policy_e::all };
+  std::string snapshot_topic_{};
+  azmq::message value_message_{};
+  azmq::message latest_header_message_{};
+  azmq::message latest_value_message_{};
+  value_t receive_value_{};
+  header_t<value_e> header_{};
+  receive_statistics statistics_{};
+  std::unique_ptr<shm::subscription> shm_{};
+  std::vector<std::byte> shm_buffer_{};
 };
 
 template <typename type_desc>
@@ -293,12 +713,25 @@ public:
 
   [[nodiscard]] static auto create(asio::io_context& ctx,
                                    std::string_view name,
-                                   tfc::stx::invocable<value_t> auto&& callback)
+                                   tfc::stx::invocable<value_t> auto&& callback,
+                                   receive_policy_e policy = receive_policy_e::all)
       -> std::shared_ptr<slot_callback<type_desc>> {
     return std::shared_ptr<slot_callback<type_desc>>(
-        new slot_callback<type_desc>{ ctx, name, std::forward<decltype(callback)>(callback) });
+        new slot_callback<type_desc>{ ctx, std::nullopt, name, std::forward<decltype(callback)>(callback), policy });
+  }
+  /// \param strand the receive operations, filters and callback run on
+  [[nodiscard]] static auto create(strand_t const& strand,
+                                   std::string_view name,
+                                   tfc::stx::invocable<value_t> auto&& callback,
+                                   receive_policy_e policy = receive_policy_e::all)
+      -> std::shared_ptr<slot_callback<type_desc>> {
+    return std::shared_ptr<slot_callback<type_desc>>(new slot_callback<type_desc>{
+        strand.get_inner_executor().context(), strand, name, std::forward<decltype(callback)>(callback), policy });
   }
 
+  /// \return the strand of the slot, or the executor of its io_context if it is single threaded
+  [[nodiscard]] auto executor() const -> asio::any_io_executor { return slot_.executor(); }
+
   auto connect(std::string_view signal_name) -> std::error_code {
     if (auto error = slot_.connect(signal_name)) {
       return error;
@@ -308,6 +741,8 @@ public:
   }
   [[nodiscard]] auto value() const noexcept -> std::optional<value_t> const& { return filters_.value(); }
 
+  [[nodiscard]] auto statistics() const noexcept -> receive_statistics const& { return slot_.statistics(); }
+
   /**
    * @brief disconnect from signal
    */
@@ -317,34 +752,45 @@ public:
   [[nodiscard]] auto name_w_type() const -> std::string { return slot_.name_w_type(); }
 
 private:
-  slot_callback(asio::io_context& ctx, std::string_view name, tfc::stx::invocable<value_t> auto&& callback)
-      : slot_{ ctx, name },
-        filters_{ ctx, fmt::format("{}.{}", type_desc::type_name, name), std::forward<decltype(callback)>(callback) } {}
-  void async_new_state(std::expected<value_t, std::error_code> value) {
-    if (!value) {
+  slot_callback(asio::io_context& ctx,
+                std::optional<strand_t> const& strand,
+                std::string_view name,
+                tfc::stx::invocable<value_t> auto&& callback,
+                receive_policy_e policy)
+      : slot_{ strand ? slot<type_desc>{ strand.value(), name, policy } : slot<type_desc>{ ctx, name, policy } },
+        filters_{ ctx, fmt::format("{}.{}", type_desc::type_name, name), std::forward<decltype(callback)>(callback),
+                  slot_.executor() } {}
+  void async_new_state(std::error_code const& err) {
+    if (err) {
       return;
     }
     // Don't retransmit transmitted things.
     // clang-format off
     auto const& last_value{ filters_.value() };
     PRAGMA_CLANG_WARNING_PUSH_OFF(-Wfloat-equal)
-    if (!last_value.has_value() || value.value() != last_value) {
+    if (!last_value.has_value() || receive_value_ != last_value) {
     PRAGMA_CLANG_WARNING_POP
       // clang-format on
-      filters_(std::move(value.value()));
+      // moving into the filters hands back the buffer of the former value, keeping string capacity in circulation
+      filters_(std::move(receive_value_));
     }
     register_read();
   }
   void register_read() {
     auto bind_reference = std::enable_shared_from_this<slot_callback<type_desc>>::weak_from_this();
-    slot_.async_receive([bind_reference](std::expected<value_t, std::error_code> value) {
+    slot_.async_receive_into(receive_value_, [bind_reference](std::error_code const& err) {
       if (auto sptr = bind_reference.lock()) {
-        sptr->async_new_state(value);
+        sptr->async_new_state(err);
       }
     });
   }
   slot<type_desc> slot_;
-  filter::filters<value_t, std::function<void(value_t&)>> filters_;  // todo prefer some other type erasure mechanism
+  value_t receive_value_{};
+  using any_filter_t = std::conditional_t<type_desc::value_e == type_e::_json,
+                                          filter::detail::any_json_filter_decl_t,
+                                          filter::detail::any_filter_decl_t<value_t>>;
+  // the callback of tfc::ipc::slot emitting the value on dbus fits inline, one indirect call per value
+  filter::filters<value_t, tfc::stx::small_function<void(value_t&)>, any_filter_t> filters_;
 };
 
 template <typename return_t, template <typename description_t> typename ipc_base_t>
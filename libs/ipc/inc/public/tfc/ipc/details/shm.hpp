@@ -0,0 +1,594 @@
+#pragma once
+
+// Shared memory transport for signals and slots living on the same host.
+// A signal owns a single writer seqlock slot in a POSIX shared memory object, slots map it read only.
+// Each slot hands the signal its own eventfd over a unix domain socket (SCM_RIGHTS),
+// the signal bumps the eventfds after every write which wakes up the slots through their io_context.
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <boost/asio/compose.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <tfc/ipc/details/strand.hpp>
+#include <tfc/utils/socket.hpp>
+
+namespace tfc::ipc::details {
+
+/// \brief Transport used by a signal to deliver values to its slots
+enum struct transport_e : std::uint8_t {
+  zmq = 0,  // ZeroMQ pub/sub over ipc:// endpoints, the default
+  shm = 1,  // Shared memory seqlock slot for latest value slots on the same host, zmq serves every other slot
+};
+
+namespace shm {
+
+namespace asio = boost::asio;
+
+/// \brief Default amount of bytes initially reserved for a serialized packet in the shared memory slot
+/// The segment grows when a larger packet is written, see segment::write.
+inline constexpr std::size_t default_capacity{ 4096 };
+
+/// \brief Max reads of a torn seqlock slot before giving up and waiting for the next notification
+inline constexpr std::size_t max_read_retries{ 64 };
+
+/// \return POSIX shared memory object name for the given signal, `/tfc.<name_w_type>`
+inline auto segment_name(std::string_view signal_name) -> std::string {
+  return fmt::format("/tfc.{}", signal_name);
+}
+
+/// \return unix domain socket path where the signal accepts shm subscribers, `/tmp/<name_w_type>.shm`
+inline auto notify_endpoint(std::string_view signal_name) -> std::string {
+  return fmt::format("{}{}.shm", utils::socket::file_path, signal_name);
+}
+
+inline auto last_error() -> std::error_code {
+  int const err{ errno };
+  return std::make_error_code(static_cast<std::errc>(err));
+}
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared memory seqlock requires lock free 64 bit atomics");
+
+/// \brief Layout of the beginning of the shared memory object, the packet bytes follow
+struct alignas(64) segment_header {
+  std::atomic<std::uint64_t> sequence{};  // odd while the writer is writing, 0 if nothing has been written
+  std::atomic<std::uint64_t> size{};
+  std::atomic<std::uint64_t> capacity{};  // only grows, the object is resized before it is raised
+};
+
+/// \brief RAII owner of a mapped shared memory seqlock slot
+/// The creator (signal) is the only writer and unlinks the object on destruction.
+/// The writer grows the object for packets larger than its capacity, readers map it again when they see a larger one.
+class segment {
+public:
+  segment() = default;
+  segment(segment const&) = delete;
+  auto operator=(segment const&) -> segment& = delete;
+  segment(segment&& other) noexcept
+      : name_{ std::move(other.name_) }, fd_{ std::exchange(other.fd_, -1) },
+        mapping_{ std::exchange(other.mapping_, nullptr) }, mapping_size_{ std::exchange(other.mapping_size_, 0) },
+        owner_{ std::exchange(other.owner_, false) } {}
+  auto operator=(segment&& other) noexcept -> segment& {
+    if (this != &other) {
+      release();
+      name_ = std::move(other.name_);
+      fd_ = std::exchange(other.fd_, -1);
+      mapping_ = std::exchange(other.mapping_, nullptr);
+      mapping_size_ = std::exchange(other.mapping_size_, 0);
+      owner_ = std::exchange(other.owner_, false);
+    }
+    return *this;
+  }
+  ~segment() { release(); }
+
+  /// \brief create a writable segment, stale segments of the same name are replaced
+  [[nodiscard]] static auto create(std::string_view signal_name, std::size_t capacity = default_capacity)
+      -> std::expected<segment, std::error_code> {
+    segment result{};
+    result.name_ = segment_name(signal_name);
+    ::shm_unlink(result.name_.c_str());
+    result.fd_ = ::shm_open(result.name_.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0660);
+    if (result.fd_ < 0) {
+      return std::unexpected(last_error());
+    }
+    result.owner_ = true;
+    result.mapping_size_ = sizeof(segment_header) + capacity;
+    if (::ftruncate(result.fd_, static_cast<off_t>(result.mapping_size_)) != 0) {
+      return std::unexpected(last_error());
+    }
+    result.mapping_ = ::mmap(nullptr, result.mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, result.fd_, 0);
+    if (result.mapping_ == MAP_FAILED) {
+      result.mapping_ = nullptr;
+      return std::unexpected(last_error());
+    }
+    new (result.mapping_) segment_header{ .sequence = {}, .size = {}, .capacity = capacity };
+    return result;
+  }
+
+  /// \brief open an existing segment read only
+  [[nodiscard]] static auto open(std::string_view signal_name) -> std::expected<segment, std::error_code> {
+    segment result{};
+    result.name_ = segment_name(signal_name);
+    result.fd_ = ::shm_open(result.name_.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (result.fd_ < 0) {
+      return std::unexpected(last_error());
+    }
+    struct stat file_stat {};
+    if (::fstat(result.fd_, &file_stat) != 0) {
+      return std::unexpected(last_error());
+    }
+    result.mapping_size_ = static_cast<std::size_t>(file_stat.st_size);
+    if (result.mapping_size_ < sizeof(segment_header)) {
+      return std::unexpected(std::make_error_code(std::errc::message_size));
+    }
+    result.mapping_ = ::mmap(nullptr, result.mapping_size_, PROT_READ, MAP_SHARED, result.fd_, 0);
+    if (result.mapping_ == MAP_FAILED) {
+      result.mapping_ = nullptr;
+      return std::unexpected(last_error());
+    }
+    // a capacity beyond the mapping means the writer has grown the segment since, read maps it again
+    return result;
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return header().capacity.load(std::memory_order_acquire); }
+
+  /// \return sequence number of the last complete write, 0 if nothing has been written
+  [[nodiscard]] auto sequence() const noexcept -> std::uint64_t {
+    return header().sequence.load(std::memory_order_acquire) & ~std::uint64_t{ 1 };
+  }
+
+  /// \brief Single writer update of the slot, the given buffers are written back to back
+  /// \note never blocks, readers retry if they observe a torn write
+  /// \return error if the segment could not be grown to fit the buffers
+  auto write(std::span<std::span<std::byte const> const> buffers) noexcept -> std::error_code {
+    std::size_t total{};
+    for (auto const& buffer : buffers) {
+      total += buffer.size();
+    }
+    if (total > capacity()) {
+      if (auto error{ grow(total) }) {
+        return error;
+      }
+    }
+    auto& head{ header() };
+    auto const sequence{ head.sequence.load(std::memory_order_relaxed) };
+    head.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    head.size.store(total, std::memory_order_relaxed);
+    auto* destination{ data() };
+    for (auto const& buffer : buffers) {
+      std::memcpy(destination, buffer.data(), buffer.size());
+      destination += buffer.size();
+    }
+    head.sequence.store(sequence + 2, std::memory_order_release);
+    return {};
+  }
+
+  auto write(std::span<std::byte const> buffer) noexcept -> std::error_code {
+    std::array<std::span<std::byte const>, 1> const buffers{ buffer };
+    return write(buffers);
+  }
+
+  /// \brief Copy the current packet into buffer
+  /// \param buffer resized to the packet size
+  /// \return sequence number of the copied packet
+  auto read(std::vector<std::byte>& buffer) -> std::expected<std::uint64_t, std::error_code> {
+    for (std::size_t retry = 0; retry < max_read_retries; retry++) {
+      // the header is looked up on each try, a remap moves it
+      auto const& head{ header() };
+      auto const before{ head.sequence.load(std::memory_order_acquire) };
+      if ((before & 1) != 0) {
+        continue;
+      }
+      auto const size{ head.size.load(std::memory_order_relaxed) };
+      if (size > mapped_capacity()) {
+        // the writer has grown the segment, or the size is torn
+        if (size <= head.capacity.load(std::memory_order_acquire)) {
+          if (auto error{ remap(sizeof(segment_header) + size) }) {
+            return std::unexpected(error);
+          }
+        }
+        continue;
+      }
+      buffer.resize(size);
+      std::memcpy(buffer.data(), data(), size);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (head.sequence.load(std::memory_order_relaxed) == before) {
+        return before;
+      }
+    }
+    return std::unexpected(std::make_error_code(std::errc::resource_unavailable_try_again));
+  }
+
+private:
+  [[nodiscard]] auto mapped_capacity() const noexcept -> std::size_t { return mapping_size_ - sizeof(segment_header); }
+
+  /// \brief resize the object to fit a packet of at least the given size and raise the capacity
+  auto grow(std::size_t size) noexcept -> std::error_code {
+    auto const capacity{ std::max(size, 2 * this->capacity()) };
+    if (::ftruncate(fd_, static_cast<off_t>(sizeof(segment_header) + capacity)) != 0) {
+      return last_error();
+    }
+    if (auto error{ remap(sizeof(segment_header) + capacity) }) {
+      return error;
+    }
+    header().capacity.store(capacity, std::memory_order_release);
+    return {};
+  }
+
+  /// \brief map the object again with the given size, it is at least as large once the capacity covers it
+  auto remap(std::size_t size) noexcept -> std::error_code {
+    struct stat file_stat {};
+    if (::fstat(fd_, &file_stat) != 0) {
+      return last_error();
+    }
+    auto const file_size{ static_cast<std::size_t>(file_stat.st_size) };
+    if (file_size < size) {
+      return std::make_error_code(std::errc::message_size);
+    }
+    void* mapping{ ::mremap(mapping_, mapping_size_, file_size, MREMAP_MAYMOVE) };
+    if (mapping == MAP_FAILED) {
+      return last_error();
+    }
+    mapping_ = mapping;
+    mapping_size_ = file_size;
+    return {};
+  }
+
+  void release() noexcept {
+    if (mapping_ != nullptr) {
+      ::munmap(mapping_, mapping_size_);
+      mapping_ = nullptr;
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    if (owner_) {
+      ::shm_unlink(name_.c_str());
+      owner_ = false;
+    }
+  }
+  [[nodiscard]] auto header() const noexcept -> segment_header& { return *static_cast<segment_header*>(mapping_); }
+  [[nodiscard]] auto data() const noexcept -> std::byte* {
+    return static_cast<std::byte*>(mapping_) + sizeof(segment_header);
+  }
+
+  std::string name_{};
+  int fd_{ -1 };
+  void* mapping_{ nullptr };
+  std::size_t mapping_size_{};
+  bool owner_{ false };
+};
+
+/// \brief send a file descriptor over a connected unix domain socket
+inline auto send_fd(int socket_fd, int fd_to_send) -> std::error_code {
+  std::byte payload{};
+  iovec io_vector{ .iov_base = &payload, .iov_len = sizeof(payload) };
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+  msghdr message{};
+  message.msg_iov = &io_vector;
+  message.msg_iovlen = 1;
+  message.msg_control = control.data();
+  message.msg_controllen = control.size();
+  cmsghdr* control_message{ CMSG_FIRSTHDR(&message) };
+  control_message->cmsg_level = SOL_SOCKET;
+  control_message->cmsg_type = SCM_RIGHTS;
+  control_message->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(control_message), &fd_to_send, sizeof(int));
+  if (::sendmsg(socket_fd, &message, MSG_NOSIGNAL) < 0) {
+    return last_error();
+  }
+  return {};
+}
+
+/// \brief receive a file descriptor from a connected unix domain socket
+inline auto receive_fd(int socket_fd) -> std::expected<int, std::error_code> {
+  std::byte payload{};
+  iovec io_vector{ .iov_base = &payload, .iov_len = sizeof(payload) };
+  alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+  msghdr message{};
+  message.msg_iov = &io_vector;
+  message.msg_iovlen = 1;
+  message.msg_control = control.data();
+  message.msg_controllen = control.size();
+  auto const received{ ::recvmsg(socket_fd, &message, MSG_CMSG_CLOEXEC) };
+  if (received < 0) {
+    return std::unexpected(last_error());
+  }
+  if (received == 0) {
+    return std::unexpected(std::make_error_code(std::errc::connection_reset));
+  }
+  for (cmsghdr* control_message = CMSG_FIRSTHDR(&message); control_message != nullptr;
+       control_message = CMSG_NXTHDR(&message, control_message)) {
+    if (control_message->cmsg_level == SOL_SOCKET && control_message->cmsg_type == SCM_RIGHTS) {
+      int result{ -1 };
+      std::memcpy(&result, CMSG_DATA(control_message), sizeof(int));
+      return result;
+    }
+  }
+  return std::unexpected(std::make_error_code(std::errc::bad_message));
+}
+
+/**@brief
+ * Signal side of the shared memory transport.
+ * Owns the writable segment and notifies all subscribed slots after each publish.
+ * */
+class publisher {
+public:
+  /// \param strand of the signal, the slots are accepted and removed on it as publish walks them on it
+  [[nodiscard]] static auto create(asio::io_context& ctx,
+                                   std::string_view signal_name,
+                                   std::size_t capacity,
+                                   std::optional<strand_t> strand = std::nullopt)
+      -> std::expected<std::unique_ptr<publisher>, std::error_code> {
+    auto mem{ segment::create(signal_name, capacity) };
+    if (!mem) {
+      return std::unexpected(mem.error());
+    }
+    auto result{
+      std::unique_ptr<publisher>(new publisher(ctx, signal_name, std::move(mem.value()), std::move(strand)))
+    };
+    if (auto error{ result->listen() }) {
+      return std::unexpected(error);
+    }
+    return result;
+  }
+
+  publisher(publisher const&) = delete;
+  auto operator=(publisher const&) -> publisher& = delete;
+  publisher(publisher&&) = delete;
+  auto operator=(publisher&&) -> publisher& = delete;
+
+  ~publisher() {
+    std::error_code ignore{};
+    std::filesystem::remove(endpoint_, ignore);
+  }
+
+  /// \brief write packet bytes to shared memory and wake all subscribed slots
+  auto publish(std::span<std::span<std::byte const> const> buffers) -> std::error_code {
+    if (auto error{ segment_.write(buffers) }) {
+      return error;
+    }
+    std::uint64_t const increment{ 1 };
+    for (auto const& sub : subscribers_) {
+      // Failure means the counter is saturated, the slot is woken up regardless
+      [[maybe_unused]] auto const written{ ::write(sub->event_fd, &increment, sizeof(increment)) };
+    }
+    return {};
+  }
+
+  auto publish(std::span<std::byte const> buffer) -> std::error_code {
+    std::array<std::span<std::byte const>, 1> const buffers{ buffer };
+    return publish(buffers);
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return segment_.capacity(); }
+
+  [[nodiscard]] auto subscriber_count() const noexcept -> std::size_t { return subscribers_.size(); }
+
+private:
+  struct subscriber {
+    explicit subscriber(asio::local::stream_protocol::socket&& sock) : control{ std::move(sock) } {}
+    subscriber(subscriber const&) = delete;
+    auto operator=(subscriber const&) -> subscriber& = delete;
+    ~subscriber() {
+      if (event_fd >= 0) {
+        ::close(event_fd);
+      }
+    }
+    asio::local::stream_protocol::socket control;
+    int event_fd{ -1 };
+  };
+
+  publisher(asio::io_context& ctx, std::string_view signal_name, segment&& mem, std::optional<strand_t> strand)
+      : segment_{ std::move(mem) }, endpoint_{ notify_endpoint(signal_name) }, acceptor_{ ctx },
+        strand_{ std::move(strand) } {}
+
+  auto listen() -> std::error_code {
+    std::error_code ignore{};
+    std::filesystem::remove(endpoint_, ignore);
+    boost::system::error_code error_code;
+    asio::local::stream_protocol::endpoint const endpoint{ endpoint_ };
+    if (acceptor_.open(endpoint.protocol(), error_code)) {
+      return error_code;
+    }
+    if (acceptor_.bind(endpoint, error_code)) {
+      return error_code;
+    }
+    if (acceptor_.listen(asio::socket_base::max_listen_connections, error_code)) {
+      return error_code;
+    }
+    async_accept();
+    return {};
+  }
+
+  void async_accept() {
+    initiate_on(
+        strand_, [this](auto&& handler) { acceptor_.async_accept(std::forward<decltype(handler)>(handler)); },
+        [this](boost::system::error_code const& error_code, asio::local::stream_protocol::socket sock) {
+          if (error_code == asio::error::operation_aborted) {
+            return;  // publisher destroyed, `this` is dangling
+          }
+          if (!error_code) {
+            auto& sub{ subscribers_.emplace_back(std::make_unique<subscriber>(std::move(sock))) };
+            await_event_fd(sub.get());
+          }
+          async_accept();
+        });
+  }
+
+  /// \brief wait for the control socket of sub to become readable, handler is run on the strand if there is one
+  void async_wait_control(subscriber* sub, auto&& handler) {
+    initiate_on(
+        strand_,
+        [sub](auto&& bound) { sub->control.async_wait(asio::socket_base::wait_read, std::forward<decltype(bound)>(bound)); },
+        std::forward<decltype(handler)>(handler));
+  }
+
+  void await_event_fd(subscriber* sub) {
+    async_wait_control(sub, [this, sub](boost::system::error_code const& error_code) {
+      if (error_code == asio::error::operation_aborted) {
+        return;
+      }
+      if (error_code) {
+        remove(sub);
+        return;
+      }
+      auto event_fd{ receive_fd(sub->control.native_handle()) };
+      if (!event_fd) {
+        remove(sub);
+        return;
+      }
+      sub->event_fd = event_fd.value();
+      // A value published between the slot connecting and now has not notified it, it is woken up to read it
+      if (segment_.sequence() != 0) {
+        std::uint64_t const increment{ 1 };
+        [[maybe_unused]] auto const written{ ::write(sub->event_fd, &increment, sizeof(increment)) };
+      }
+      await_hangup(sub);
+    });
+  }
+
+  void await_hangup(subscriber* sub) {
+    async_wait_control(sub, [this, sub](boost::system::error_code const& error_code) {
+      if (error_code == asio::error::operation_aborted) {
+        return;
+      }
+      // The slot never writes after handing over its eventfd, readability means it has hung up
+      remove(sub);
+    });
+  }
+
+  void remove(subscriber* sub) {
+    std::erase_if(subscribers_, [sub](auto const& item) { return item.get() == sub; });
+  }
+
+  segment segment_;
+  std::string endpoint_;
+  asio::local::stream_protocol::acceptor acceptor_;
+  std::optional<strand_t> strand_{};
+  std::vector<std::unique_ptr<subscriber>> subscribers_{};  // added, removed and walked on strand_
+};
+
+/**@brief
+ * Slot side of the shared memory transport.
+ * Maps the segment of a signal and gets woken up through an eventfd registered with the io_context.
+ * */
+class subscription {
+public:
+  /// \brief subscribe to the shared memory segment of the given signal
+  /// \return error if the signal does not publish over shared memory
+  [[nodiscard]] static auto connect(asio::io_context& ctx, std::string_view signal_name)
+      -> std::expected<std::unique_ptr<subscription>, std::error_code> {
+    auto mem{ segment::open(signal_name) };
+    if (!mem) {
+      return std::unexpected(mem.error());
+    }
+    auto result{ std::unique_ptr<subscription>(new subscription(ctx, std::move(mem.value()))) };
+
+    boost::system::error_code error_code;
+    if (result->control_.connect(asio::local::stream_protocol::endpoint{ notify_endpoint(signal_name) }, error_code)) {
+      return std::unexpected(error_code);
+    }
+    int const event_fd{ ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) };
+    if (event_fd < 0) {
+      return std::unexpected(last_error());
+    }
+    result->event_.assign(event_fd);
+    if (auto error{ send_fd(result->control_.native_handle(), event_fd) }) {
+      return std::unexpected(error);
+    }
+    return result;
+  }
+
+  subscription(subscription const&) = delete;
+  auto operator=(subscription const&) -> subscription& = delete;
+  subscription(subscription&&) = delete;
+  auto operator=(subscription&&) -> subscription& = delete;
+  ~subscription() = default;
+
+  /// \return true if the signal has published a value this subscription has not read yet
+  [[nodiscard]] auto has_pending() const noexcept -> bool {
+    auto const sequence{ segment_.sequence() };
+    return sequence != 0 && sequence != last_sequence_;
+  }
+
+  /// \brief copy the newest packet into buffer
+  /// \note intermediate values written between two reads are not observed, this is latest value semantics
+  auto read(std::vector<std::byte>& buffer) -> std::error_code {
+    auto sequence{ segment_.read(buffer) };
+    if (!sequence) {
+      return sequence.error();
+    }
+    last_sequence_ = sequence.value();
+    return {};
+  }
+
+  /// \brief wait for the signal to notify a new value
+  /// \param token completion token with signature void(std::error_code)
+  template <typename completion_token_t>
+  auto async_wait(completion_token_t&& token) {
+    auto& event{ event_ };
+    return asio::async_compose<completion_token_t, void(std::error_code)>(
+        [&event, waiting = false](auto& self, boost::system::error_code const& error_code = {}) mutable {
+          if (!waiting) {
+            waiting = true;
+            event.async_wait(asio::posix::stream_descriptor::wait_read, std::move(self));
+            return;
+          }
+          if (error_code) {
+            self.complete(error_code);
+            return;
+          }
+          std::uint64_t counter{};
+          // reset the eventfd counter, EAGAIN only means some other read got to it first
+          [[maybe_unused]] auto const bytes_read{ ::read(event.native_handle(), &counter, sizeof(counter)) };
+          self.complete({});
+        },
+        token, event_);
+  }
+
+  /// \brief cancel outstanding wait
+  void cancel() {
+    boost::system::error_code ignore;
+    event_.cancel(ignore);
+  }
+
+private:
+  subscription(asio::io_context& ctx, segment&& mem) : segment_{ std::move(mem) }, control_{ ctx }, event_{ ctx } {}
+
+  segment segment_;
+  asio::local::stream_protocol::socket control_;
+  asio::posix::stream_descriptor event_;
+  std::uint64_t last_sequence_{};
+};
+
+}  // namespace shm
+
+}  // namespace tfc::ipc::details
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace tfc::ipc::filter::detail {
+
+/// \brief fixed capacity ring of the latest values, storage is allocated by reset only
+template <typename value_t>
+class ring {
+public:
+  void reset(std::size_t capacity) {
+    values_.assign(capacity, value_t{});
+    head_ = 0;
+    size_ = 0;
+  }
+
+  [[nodiscard]] auto capacity() const noexcept -> std::size_t { return values_.size(); }
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+  [[nodiscard]] auto full() const noexcept -> bool { return size_ == values_.size(); }
+
+  /// \brief overwrite the oldest value once full, see oldest()
+  /// \pre capacity() > 0
+  void push(value_t value) noexcept {
+    values_[head_] = value;
+    head_ = head_ + 1 == values_.size() ? 0 : head_ + 1;
+    if (size_ < values_.size()) {
+      size_++;
+    }
+  }
+
+  /// \return value which the next push overwrites
+  /// \pre full()
+  [[nodiscard]] auto oldest() const noexcept -> value_t const& { return values_[head_]; }
+
+  [[nodiscard]] auto begin() const noexcept { return values_.begin(); }
+  [[nodiscard]] auto end() const noexcept { return values_.begin() + static_cast<std::ptrdiff_t>(size_); }
+
+private:
+  std::vector<value_t> values_{};
+  std::size_t head_{};
+  std::size_t size_{};
+};
+
+/**
+ * @brief
+ * Multiset of values answering which value has a given rank in O(log n).
+ * A treap whose nodes live in a pool sized by reset, so inserting and erasing never allocates.
+ */
+template <typename value_t>
+class order_statistics {
+public:
+  /// \brief remove every value and make room for capacity values
+  void reset(std::size_t capacity) {
+    nodes_.assign(capacity, node{});
+    free_.clear();
+    free_.reserve(capacity);
+    for (std::size_t idx{ capacity }; idx > 0; idx--) {
+      free_.emplace_back(static_cast<index_t>(idx - 1));
+    }
+    root_ = nil;
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_of(root_); }
+
+  /// \pre size() < capacity given to reset
+  void insert(value_t value) noexcept {
+    auto const idx{ free_.back() };
+    free_.pop_back();
+    nodes_[idx] = node{ .value = value, .priority = next_priority(), .size = 1, .left = nil, .right = nil };
+    auto [less, greater_equal] = split(root_, value);
+    root_ = merge(merge(less, idx), greater_equal);
+  }
+
+  /// \brief erase one value equal to value
+  /// \return false if there is none
+  auto erase(value_t const& value) noexcept -> bool {
+    bool erased{ false };
+    root_ = erase(root_, value, erased);
+    return erased;
+  }
+
+  /// \param rank zero based, 0 is the smallest value
+  /// \pre rank < size()
+  [[nodiscard]] auto nth(std::size_t rank) const noexcept -> value_t const& {
+    auto current{ root_ };
+    for (;;) {
+      auto const left_size{ size_of(nodes_[current].left) };
+      if (rank < left_size) {
+        current = nodes_[current].left;
+      } else if (rank == left_size) {
+        return nodes_[current].value;
+      } else {
+        rank -= left_size + 1;
+        current = nodes_[current].right;
+      }
+    }
+  }
+
+private:
+  using index_t = std::uint32_t;
+  static constexpr index_t nil{ std::numeric_limits<index_t>::max() };
+
+  struct node {
+    value_t value{};
+    std::uint32_t priority{};
+    std::uint32_t size{};
+    index_t left{ nil };
+    index_t right{ nil };
+  };
+
+  struct split_t {
+    index_t less{ nil };
+    index_t greater_equal{ nil };
+  };
+
+  [[nodiscard]] auto size_of(index_t idx) const noexcept -> std::size_t { return idx == nil ? 0 : nodes_[idx].size; }
+
+  void update(index_t idx) noexcept {
+    auto& current{ nodes_[idx] };
+    current.size = static_cast<std::uint32_t>(1 + size_of(current.left) + size_of(current.right));
+  }
+
+  /// \brief xorshift32, only used to keep the treap balanced in expectation
+  auto next_priority() noexcept -> std::uint32_t {
+    seed_ ^= seed_ << 13U;
+    seed_ ^= seed_ >> 17U;
+    seed_ ^= seed_ << 5U;
+    return seed_;
+  }
+
+  auto split(index_t idx, value_t const& value) noexcept -> split_t {
+    if (idx == nil) {
+      return {};
+    }
+    if (nodes_[idx].value < value) {
+      auto const parts{ split(nodes_[idx].right, value) };
+      nodes_[idx].right = parts.less;
+      update(idx);
+      return { .less = idx, .greater_equal = parts.greater_equal };
+    }
+    auto const parts{ split(nodes_[idx].left, value) };
+    nodes_[idx].left = parts.greater_equal;
+    update(idx);
+    return { .less = parts.less, .greater_equal = idx };
+  }
+
+  /// \pre every value in lhs <= every value in rhs
+  auto merge(index_t lhs, index_t rhs) noexcept -> index_t {
+    if (lhs == nil) {
+      return rhs;
+    }
+    if (rhs == nil) {
+      return lhs;
+    }
+    if (nodes_[lhs].priority > nodes_[rhs].priority) {
+      nodes_[lhs].right = merge(nodes_[lhs].right, rhs);
+      update(lhs);
+      return lhs;
+    }
+    nodes_[rhs].left = merge(lhs, nodes_[rhs].left);
+    update(rhs);
+    return rhs;
+  }
+
+  auto erase(index_t idx, value_t const& value, bool& erased) noexcept -> index_t {
+    if (idx == nil) {
+      return nil;
+    }
+    auto& current{ nodes_[idx] };
+    if (value < current.value) {
+      current.left = erase(current.left, value, erased);
+    } else if (current.value < value) {
+      current.right = erase(current.right, value, erased);
+    } else {
+      erased = true;
+      free_.emplace_back(idx);
+      return merge(current.left, current.right);
+    }
+    update(idx);
+    return idx;
+  }
+
+  std::vector<node> nodes_{};
+  std::vector<index_t> free_{};
+  index_t root_{ nil };
+  std::uint32_t seed_{ 2463534242U };
+};
+
+/// \brief latest values kept in order, for median and quantile
+template <typename value_t>
+class sorted_window {
+public:
+  void reset(std::size_t window_size) {
+    ring_.reset(window_size);
+    sorted_.reset(window_size);
+  }
+
+  void push(value_t value) noexcept {
+    if (ring_.full()) {
+      sorted_.erase(ring_.oldest());
+    }
+    ring_.push(value);
+    sorted_.insert(value);
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return ring_.size(); }
+
+  /// \pre rank < size()
+  [[nodiscard]] auto nth(std::size_t rank) const noexcept -> value_t const& { return sorted_.nth(rank); }
+
+private:
+  ring<value_t> ring_{};
+  order_statistics<value_t> sorted_{};
+};
+
+/// \brief latest values and their running sum, for moving averages
+template <typename value_t>
+class summed_window {
+public:
+  void reset(std::size_t window_size) {
+    ring_.reset(window_size);
+    sum_ = 0;
+    pushed_ = 0;
+  }
+
+  void push(value_t value) noexcept {
+    if (ring_.full()) {
+      sum_ -= static_cast<long double>(ring_.oldest());
+    }
+    ring_.push(value);
+    sum_ += static_cast<long double>(value);
+    // Sum anew once per window so rounding errors of floating values do not accumulate
+    if (++pushed_ == ring_.capacity()) {
+      pushed_ = 0;
+      sum_ = std::accumulate(ring_.begin(), ring_.end(), 0.0L,
+                             [](long double sum, value_t item) { return sum + static_cast<long double>(item); });
+    }
+  }
+
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return ring_.size(); }
+
+  /// \pre size() > 0
+  [[nodiscard]] auto mean() const noexcept -> long double { return sum_ / static_cast<long double>(ring_.size()); }
+
+private:
+  ring<value_t> ring_{};
+  long double sum_{};
+  std::size_t pushed_{};
+};
+
+/// \brief decides which values of a sliding window are passed on, see the send_every of ESPHome sensor filters
+class send_counter {
+public:
+  void reset(std::size_t send_every, std::size_t send_first_at) noexcept {
+    send_every_ = send_every == 0 ? 1 : send_every;
+    // the first value is sent once send_first_at values have been received
+    count_ = send_first_at >= send_every_ ? 0 : send_every_ - (send_first_at == 0 ? 1 : send_first_at);
+  }
+
+  /// \return true if the value just received is to be sent
+  auto next() noexcept -> bool {
+    if (++count_ >= send_every_) {
+      count_ = 0;
+      return true;
+    }
+    return false;
+  }
+
+private:
+  std::size_t send_every_{ 1 };
+  std::size_t count_{};
+};
+
+/// \brief window_t which is reset whenever its settings change, as they do when the filter is reconfigured
+template <typename window_t>
+class send_every_window {
+public:
+  /// \return true if the value is to be sent
+  auto push(auto value, std::size_t window_size, std::size_t send_every, std::size_t send_first_at) -> bool {
+    if (window_size == 0) {
+      window_size = 1;
+    }
+    if (window_size != window_size_ || send_every != send_every_ || send_first_at != send_first_at_) {
+      window_size_ = window_size;
+      send_every_ = send_every;
+      send_first_at_ = send_first_at;
+      window_.reset(window_size);
+      counter_.reset(send_every, send_first_at);
+    }
+    window_.push(value);
+    return counter_.next();
+  }
+
+  [[nodiscard]] auto window() const noexcept -> window_t const& { return window_; }
+
+private:
+  std::size_t window_size_{};  // zero until the first value
+  std::size_t send_every_{};
+  std::size_t send_first_at_{};
+  window_t window_{};
+  send_counter counter_{};
+};
+
+}  // namespace tfc::ipc::filter::detail
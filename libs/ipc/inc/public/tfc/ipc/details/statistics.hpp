@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <tfc/ipc/packet.hpp>
+
+namespace tfc::ipc::details {
+
+/// \return nanoseconds of the steady clock, which is CLOCK_MONOTONIC and thereby comparable between processes on a host
+inline auto monotonic_ns() noexcept -> std::uint64_t {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// \brief log2 bucketed latency histogram, bucket i counts latencies in [2^i, 2^(i+1)) nanoseconds
+class latency_histogram {
+public:
+  static constexpr std::size_t bucket_count{ 48 };  // the last bucket starts at ~39 hours
+
+  void record(std::chrono::nanoseconds latency) noexcept {
+    auto const nanoseconds{ static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 1)) };
+    auto const bucket{ std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(nanoseconds) - 1), bucket_count - 1) };
+    buckets_[bucket]++;
+    count_++;
+  }
+
+  [[nodiscard]] auto count() const noexcept -> std::uint64_t { return count_; }
+
+  /// \param quantile in the range [0, 1], 0.99 for p99
+  /// \return upper bound of the bucket holding the quantile, zero if nothing has been recorded
+  [[nodiscard]] auto quantile(double quantile) const noexcept -> std::chrono::nanoseconds {
+    if (count_ == 0) {
+      return {};
+    }
+    auto const rank{ static_cast<std::uint64_t>(quantile * static_cast<double>(count_ - 1)) + 1 };
+    std::uint64_t accumulated{};
+    for (std::size_t idx{ 0 }; idx < bucket_count; idx++) {
+      accumulated += buckets_[idx];
+      if (accumulated >= rank) {
+        return std::chrono::nanoseconds{ (std::int64_t{ 1 } << (idx + 1)) - 1 };
+      }
+    }
+    return std::chrono::nanoseconds{ (std::int64_t{ 1 } << bucket_count) - 1 };
+  }
+
+  [[nodiscard]] auto buckets() const noexcept -> std::array<std::uint64_t, bucket_count> const& { return buckets_; }
+
+private:
+  std::array<std::uint64_t, bucket_count> buckets_{};
+  std::uint64_t count_{};
+};
+
+/// \brief end to end latency and loss of the values a slot has received, populated from v1 headers
+struct receive_statistics {
+  std::uint64_t received{};
+  std::uint64_t gaps{};       // number of times one or more sequence numbers were missing
+  std::uint64_t dropped{};    // number of missing sequence numbers
+  std::uint64_t conflated{};  // number of values skipped on purpose by a latest value receiver
+  std::uint64_t errors{};     // messages which could not be deserialized, including crc mismatches
+  latency_histogram latency{};
+
+  /// \param now monotonic_ns() when the value was received
+  /// \param conflating the receiver skips values on purpose, missing sequence numbers are not counted as dropped
+  template <type_e type_v>
+  void record(header_t<type_v> const& header, std::uint64_t now, bool conflating) noexcept {
+    received++;
+    if (header.version == version_e::v0) {
+      return;  // carries neither sequence nor timestamp
+    }
+    if (header.timestamp != 0 && now >= header.timestamp) {
+      latency.record(std::chrono::nanoseconds{ now - header.timestamp });
+    }
+    // An equal sequence is a snapshot of the latest value, a lower one means the signal has restarted
+    if (last_sequence_.has_value() && header.sequence > last_sequence_.value() + 1) {
+      auto const missing{ header.sequence - last_sequence_.value() - 1 };
+      if (conflating) {
+        conflated += missing;
+      } else {
+        gaps++;
+        dropped += missing;
+      }
+    }
+    last_sequence_ = header.sequence;
+  }
+
+private:
+  std::optional<std::uint64_t> last_sequence_{};
+};
+
+}  // namespace tfc::ipc::details
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <optional>
+#include <utility>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+namespace tfc::ipc::details {
+
+namespace asio = boost::asio;
+
+/// \brief Serializes the handlers of a signal or slot which is used from more than one thread
+using strand_t = asio::strand<asio::io_context::executor_type>;
+
+/// \brief invoke initiation with handler, bound to the strand if there is one
+/// Completions of the socket then run on the strand regardless of the thread which runs the io_context.
+void initiate_on(std::optional<strand_t> const& strand, auto&& initiation, auto&& handler) {
+  if (strand) {
+    initiation(asio::bind_executor(strand.value(), std::forward<decltype(handler)>(handler)));
+  } else {
+    initiation(std::forward<decltype(handler)>(handler));
+  }
+}
+
+}  // namespace tfc::ipc::details
@@ -185,6 +185,9 @@ struct item {
   using time_point = std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds>;
 
   [[nodiscard]] static auto from_json(std::string_view json) -> std::expected<item, glz::parse_error>;
+  /// \brief check that json reads as an item, without allocating once buffer has grown to fit
+  /// \param buffer read into and reused between calls, its content is unspecified afterwards
+  [[nodiscard]] static auto validate(std::string_view json, item& buffer) -> std::expected<void, glz::parse_error>;
   [[nodiscard]] auto to_json() const -> std::string;
   [[nodiscard]] auto id() const -> std::string;
 
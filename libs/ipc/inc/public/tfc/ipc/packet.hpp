@@ -1,14 +1,20 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <ranges>
+#include <span>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <boost/crc.hpp>
+
 #include <tfc/ipc/enums.hpp>
 
 namespace tfc::ipc::details {
@@ -16,40 +22,100 @@ namespace tfc::ipc::details {
 /// \brief Enum specifying protocol version
 /// This can be changed in the future to retain backwards compatibility and still
 /// be able to change the protocol structure
-enum struct version_e : std::uint8_t { unknown, v0 };
+enum struct version_e : std::uint8_t { unknown, v0, v1 };
+
+/// \brief Bit flags of a v1 header
+enum struct header_flags_e : std::uint8_t {
+  none = 0,
+  crc = 1 << 0,  // crc field holds the crc32 of the value
+};
 
 template <type_e type_enum>
 struct header_t {
   static constexpr auto type_v{ type_enum };
-  version_e version{ version_e::v0 };
+  version_e version{ version_e::v1 };
   type_e type{ type_v };
   std::size_t value_size{};  // populated in deserialize
-  // Todo crc
-  static constexpr auto size() -> std::size_t { return sizeof(version) + sizeof(type) + sizeof(value_size); }
-  static void serialize(header_t& header, auto&& buffer) {
-    std::copy_n(reinterpret_cast<std::byte*>(&header.version), sizeof(version), std::back_inserter(buffer));
-    std::copy_n(reinterpret_cast<std::byte*>(&header.type), sizeof(type), std::back_inserter(buffer));
-    std::copy_n(reinterpret_cast<std::byte*>(&header.value_size), sizeof(value_size), std::back_inserter(buffer));
+  // v1
+  std::uint64_t timestamp{};  // steady clock nanoseconds when sent, comparable between processes on the same host
+  std::uint64_t sequence{};   // incremented by the signal for each value sent
+  header_flags_e flags{ header_flags_e::none };
+  std::uint32_t crc{};
+
+  /// \return serialized size of the given version, 0 if the version is not known
+  static constexpr auto size(version_e version) -> std::size_t {
+    constexpr std::size_t v0_size{ sizeof(version_e) + sizeof(type_e) + sizeof(std::size_t) };
+    switch (version) {
+      case version_e::v0:
+        return v0_size;
+      case version_e::v1:
+        return v0_size + sizeof(timestamp) + sizeof(sequence) + sizeof(flags) + sizeof(crc);
+      case version_e::unknown:
+        break;
+    }
+    return 0;
   }
-  static auto deserialize(header_t& result, auto&& buffer_iter) -> std::error_code {
-    std::copy_n(buffer_iter, sizeof(version), reinterpret_cast<std::byte*>(&result.version));
-    buffer_iter += sizeof(version);
-    std::copy_n(buffer_iter, sizeof(type), reinterpret_cast<std::byte*>(&result.type));
-    buffer_iter += sizeof(type);
-    std::copy_n(buffer_iter, sizeof(value_size), reinterpret_cast<std::byte*>(&result.value_size));
-    buffer_iter += sizeof(value_size);
+  /// \return serialized size of the newest version, which is the one sent
+  static constexpr auto size() -> std::size_t { return size(version_e::v1); }
 
-    if (result.type != type_v) {
-      return std::make_error_code(std::errc::wrong_protocol_type);
+  [[nodiscard]] constexpr auto has_crc() const noexcept -> bool {
+    return (std::to_underlying(flags) & std::to_underlying(header_flags_e::crc)) != 0;
+  }
+
+  /// \brief serialize into a preallocated fixed size buffer, no allocations
+  /// \note writes size(header.version) bytes
+  static void serialize(header_t const& header, std::span<std::byte, size()> buffer) noexcept {
+    auto* iter{ buffer.data() };
+    auto const write{ [&iter](auto const& field) {
+      std::memcpy(iter, &field, sizeof(field));
+      iter += sizeof(field);
+    } };
+    write(header.version);
+    write(header.type);
+    write(header.value_size);
+    if (header.version == version_e::v0) {
+      return;
     }
-    if (result.version != version_e::v0) {
+    write(header.timestamp);
+    write(header.sequence);
+    write(header.flags);
+    write(header.crc);
+  }
+  /// \note the buffer needs to hold size(version) bytes, where version is the first byte
+  static auto deserialize(header_t& result, auto&& buffer_iter) -> std::error_code {
+    auto const read{ [&buffer_iter](auto& field) {
+      std::copy_n(buffer_iter, sizeof(field), reinterpret_cast<std::byte*>(&field));
+      buffer_iter += sizeof(field);
+    } };
+    read(result.version);
+    if (result.version != version_e::v0 && result.version != version_e::v1) {
       return std::make_error_code(std::errc::wrong_protocol_type);
       // TODO: explicit version error
     }
+    read(result.type);
+    read(result.value_size);
+    if (result.version == version_e::v1) {
+      read(result.timestamp);
+      read(result.sequence);
+      read(result.flags);
+      read(result.crc);
+    }
+
+    if (result.type != type_v) {
+      return std::make_error_code(std::errc::wrong_protocol_type);
+    }
     return {};
   }
 };
-static_assert(header_t<type_e::unknown>::size() == 10);
+static_assert(header_t<type_e::unknown>::size(version_e::v0) == 10);
+static_assert(header_t<type_e::unknown>::size(version_e::v1) == 31);
+
+/// \return crc32 of the given bytes
+inline auto crc32(std::span<std::byte const> bytes) noexcept -> std::uint32_t {
+  boost::crc_32_type result{};
+  result.process_bytes(bytes.data(), bytes.size());
+  return result.checksum();
+}
 
 /// \brief packet struct to de/serialize data to socket
 template <typename value_type, type_e type_enum>
@@ -60,49 +126,165 @@ struct packet {
   header_t<type_enum> header{};
   value_t value{};
 
-  // value size is populated
-  static auto serialize(value_t const& value, std::vector<std::byte>& buffer) -> std::error_code {
-    header_t<type_enum> my_header{};
+  static constexpr auto header_size{ header_t<type_enum>::size() };
+  using header_buffer_t = std::array<std::byte, header_size>;
+  using buffer_sequence_t = std::array<std::span<std::byte const>, 2>;
 
+  /// \return view of the bytes representing value, no copy is made
+  static auto payload(value_t const& value) noexcept -> std::span<std::byte const> {
     if constexpr (std::is_fundamental_v<value_t>) {
-      my_header.value_size = sizeof(value_t);
+      return { reinterpret_cast<std::byte const*>(&value), sizeof(value_t) };
     } else {
       static_assert(std::is_member_function_pointer_v<decltype(&value_t::size)>, "Serialize for value type not supported");
       static_assert(std::is_same_v<decltype(value_t().size()), std::size_t>);
-      my_header.value_size = value.size();
+      // has member function data
+      static_assert(std::is_pointer_v<decltype(value.data())>);
+      return { reinterpret_cast<std::byte const*>(value.data()), value.size() };
     }
+  }
+
+  /// \brief scatter gather serialization, writes the header into header_buffer
+  /// \param header timestamp, sequence and flags to send, value_size and crc are populated
+  /// \return header and payload views, the payload view refers to value which needs to outlive the send
+  static auto serialize(value_t const& value, header_buffer_t& header_buffer, header_t<type_enum> header = {}) noexcept
+      -> buffer_sequence_t {
+    auto const value_bytes{ payload(value) };
+    header.value_size = value_bytes.size();
+    if (header.has_crc()) {
+      header.crc = crc32(value_bytes);
+    }
+    header_t<type_enum>::serialize(header, header_buffer);
+    return { std::span<std::byte const>{ header_buffer }.first(header_t<type_enum>::size(header.version)), value_bytes };
+  }
 
-    const std::size_t buffer_size{ header_t<type_enum>::size() + my_header.value_size };
+  // value size is populated
+  static auto serialize(value_t const& value, std::vector<std::byte>& buffer) -> std::error_code {
+    header_buffer_t header_buffer{};
+    auto const [header_bytes, value_bytes]{ serialize(value, header_buffer) };
+
+    const std::size_t buffer_size{ header_bytes.size() + value_bytes.size() };
     buffer.reserve(buffer_size);
-    header_t<type_enum>::serialize(my_header, buffer);
+    std::ranges::copy(header_bytes, std::back_inserter(buffer));
+    std::ranges::copy(value_bytes, std::back_inserter(buffer));
+
+    if (buffer.size() != buffer_size) {
+      return std::make_error_code(std::errc::message_size);
+    }
+    return {};
+  }
 
+  /// \return size of the header starting at the first byte of bytes, 0 if its version is not known
+  static auto header_size_of(std::span<std::byte const> bytes) noexcept -> std::size_t {
+    if (bytes.empty()) {
+      return 0;
+    }
+    return header_t<type_enum>::size(static_cast<version_e>(bytes.front()));
+  }
+
+  /// \brief parse and validate a header frame, any known version is accepted
+  static auto deserialize_header(std::span<std::byte const> header_bytes)
+      -> std::expected<header_t<type_enum>, std::error_code> {
+    auto const expected_size{ header_size_of(header_bytes) };
+    if (expected_size == 0) {
+      return std::unexpected(std::make_error_code(std::errc::wrong_protocol_type));
+    }
+    if (header_bytes.size() != expected_size) {
+      return std::unexpected(std::make_error_code(std::errc::message_size));
+    }
+    header_t<type_enum> my_header{};
+    if (auto err{ header_t<type_enum>::deserialize(my_header, std::begin(header_bytes)) }) {
+      return std::unexpected(err);
+    }
     if constexpr (std::is_fundamental_v<value_t>) {
-      std::copy_n(reinterpret_cast<std::byte const*>(&value), my_header.value_size, std::back_inserter(buffer));
-    } else {
-      // has member function data
-      static_assert(std::is_pointer_v<decltype(value.data())>);
-      // Todo why copy the data instead of creating a view into the data?
-      // we should use std::span
-      std::copy_n(reinterpret_cast<std::byte const*>(value.data()), my_header.value_size, std::back_inserter(buffer));
+      if (my_header.value_size != sizeof(value_t)) {
+        return std::unexpected(std::make_error_code(std::errc::message_size));
+      }
     }
+    return my_header;
+  }
 
-    if (buffer.size() != buffer_size) {
+  /// \brief deserialize from separately received header and payload frames into an existing value
+  /// \param header populated with the received header
+  /// \note reuses the capacity of result, receiving into the same string repeatedly does not allocate
+  static auto deserialize_into(value_t& result,
+                               header_t<type_enum>& header,
+                               std::span<std::byte const> header_bytes,
+                               std::span<std::byte const> value_bytes) -> std::error_code {
+    auto my_header{ deserialize_header(header_bytes) };
+    if (!my_header) {
+      return my_header.error();
+    }
+    header = my_header.value();
+    if (value_bytes.size() != header.value_size) {
       return std::make_error_code(std::errc::message_size);
     }
+    if (header.has_crc() && crc32(value_bytes) != header.crc) {
+      return std::make_error_code(std::errc::bad_message);
+    }
+    if constexpr (std::is_fundamental_v<value_t>) {
+      std::memcpy(&result, value_bytes.data(), sizeof(value_t));
+    } else {
+      result.resize(header.value_size);
+      std::memcpy(result.data(), value_bytes.data(), header.value_size);
+    }
     return {};
   }
 
+  static auto deserialize_into(value_t& result,
+                               std::span<std::byte const> header_bytes,
+                               std::span<std::byte const> value_bytes) -> std::error_code {
+    header_t<type_enum> header{};
+    return deserialize_into(result, header, header_bytes, value_bytes);
+  }
+
+  /// \brief deserialize contiguous header and payload into an existing value
+  static auto deserialize_into(value_t& result, header_t<type_enum>& header, std::span<std::byte const> buffer)
+      -> std::error_code {
+    auto const size{ header_size_of(buffer) };
+    if (size == 0) {
+      return std::make_error_code(std::errc::wrong_protocol_type);
+    }
+    if (buffer.size() < size) {
+      return std::make_error_code(std::errc::message_size);
+    }
+    return deserialize_into(result, header, buffer.first(size), buffer.subspan(size));
+  }
+
+  static auto deserialize_into(value_t& result, std::span<std::byte const> buffer) -> std::error_code {
+    header_t<type_enum> header{};
+    return deserialize_into(result, header, buffer);
+  }
+
+  /// \brief deserialize from separately received header and payload frames
+  static auto deserialize(std::span<std::byte const> header_bytes, std::span<std::byte const> value_bytes)
+      -> std::expected<value_t, std::error_code> {
+    value_t result{};
+    if (auto err{ deserialize_into(result, header_bytes, value_bytes) }) {
+      return std::unexpected(err);
+    }
+    return result;
+  }
+
   static constexpr auto deserialize(std::ranges::view auto&& buffer) -> std::expected<value_t, std::error_code> {
-    if (buffer.size() < header_t<type_enum>::size()) {
+    if (buffer.empty()) {
+      return std::unexpected(std::make_error_code(std::errc::message_size));
+    }
+    auto const header_bytes{ header_t<type_enum>::size(static_cast<version_e>(*std::begin(buffer))) };
+    if (header_bytes == 0) {
+      return std::unexpected(std::make_error_code(std::errc::wrong_protocol_type));
+    }
+    if (buffer.size() < header_bytes) {
       return std::unexpected(std::make_error_code(std::errc::message_size));
     }
 
     packet<value_t, type_v> result{};
     auto buffer_iter{ std::begin(buffer) };
-    header_t<type_enum>::deserialize(result.header, buffer_iter);
+    if (auto err{ header_t<type_enum>::deserialize(result.header, buffer_iter) }) {
+      return std::unexpected(err);
+    }
 
     // todo partial buffer?
-    if (buffer.size() != header_t<type_enum>::size() + result.header.value_size) {
+    if (buffer.size() != header_bytes + result.header.value_size) {
       return std::unexpected(std::make_error_code(std::errc::message_size));
     }
 
@@ -114,6 +296,9 @@ struct packet {
       result.value.resize(result.header.value_size);
       std::copy_n(buffer_iter, result.header.value_size, reinterpret_cast<std::byte*>(result.value.data()));
     }
+    if (result.header.has_crc() && crc32(payload(result.value)) != result.header.crc) {
+      return std::unexpected(std::make_error_code(std::errc::bad_message));
+    }
     return std::move(result.value);
   }
 };
@@ -1,5 +1,12 @@
 #include <tfc/ipc/details/dbus_client_iface.hpp>
 
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include <boost/asio/post.hpp>
 #include <glaze/glaze.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/property.hpp>
@@ -13,46 +20,96 @@
 
 namespace tfc::ipc_ruler {
 
+namespace {
+/// \return match rule of the dbus signal named member of the ipc ruler
+template <std::string_view const& member>
+auto ruler_signal_match_rule() -> std::string {
+  namespace rules = tfc::dbus::match::rules;
+  std::string rule{ rules::make_match_rule<consts::ipc_ruler_service_name, consts::ipc_ruler_interface_name,
+                                           consts::ipc_ruler_object_path, rules::type::signal>() };
+  rule.append(rules::member<member>);
+  return rule;
+}
+}  // namespace
+
 ipc_manager_client::ipc_manager_client(asio::io_context& ctx)
     : ipc_manager_client(std::make_shared<sdbusplus::asio::connection>(ctx, tfc::dbus::sd_bus_open_system())) {}
 
 ipc_manager_client::ipc_manager_client(std::shared_ptr<sdbusplus::asio::connection> connection)
-    : connection_match_rule_{ tfc::dbus::match::rules::make_match_rule<consts::ipc_ruler_service_name,
-                                                                       consts::ipc_ruler_interface_name,
-                                                                       consts::ipc_ruler_object_path,
-                                                                       tfc::dbus::match::rules::type::signal>() },
-      connection_{ std::move(connection) },
+    : connection_match_rule_{ ruler_signal_match_rule<consts::connection_change>() }, connection_{ std::move(connection) },
       connection_match_{ make_match(connection_match_rule_, std::bind_front(&ipc_manager_client::match_callback, this)) } {}
 
 ipc_manager_client::ipc_manager_client(ipc_manager_client&& to_be_erased) noexcept {
+  connection_match_rule_ = to_be_erased.connection_match_rule_;
   connection_ = std::move(to_be_erased.connection_);
   slot_callbacks_ = std::move(to_be_erased.slot_callbacks_);
+  registrations_ = std::move(to_be_erased.registrations_);
+  directory_ = std::move(to_be_erased.directory_);
   // It is pretty safe to construct new match here it mostly invokes C api where it does not explicitly throw
   // it could throw if we are out of memory, but then we are already screwed and the process will terminate.
   connection_match_ = make_match(connection_match_rule_, std::bind_front(&ipc_manager_client::match_callback, this));
+  // the matches of the former client refer to it, and it no longer has the directory
+  to_be_erased.directory_matches_.clear();
+  if (directory_->subscribed) {
+    make_directory_matches();
+  }
 }
 auto ipc_manager_client::operator=(ipc_manager_client&& to_be_erased) noexcept -> ipc_manager_client& {
+  connection_match_rule_ = to_be_erased.connection_match_rule_;
   connection_ = std::move(to_be_erased.connection_);
   slot_callbacks_ = std::move(to_be_erased.slot_callbacks_);
+  registrations_ = std::move(to_be_erased.registrations_);
+  directory_ = std::move(to_be_erased.directory_);
   // It is pretty safe to construct new match here it mostly invokes C api where it does not explicitly throw
   // it could throw if we are out of memory, but then we are already screwed and the process will terminate.
   connection_match_ = make_match(connection_match_rule_, std::bind_front(&ipc_manager_client::match_callback, this));
+  to_be_erased.directory_matches_.clear();
+  directory_matches_.clear();
+  if (directory_->subscribed) {
+    make_directory_matches();
+  }
   return *this;
 }
 auto ipc_manager_client::register_signal(const std::string_view name,
                                          const std::string_view description,
                                          ipc::details::type_e type,
                                          std::function<void(std::error_code const&)>&& handler) -> void {
-  connection_->async_method_call(std::move(handler), ipc_ruler_service_name_, ipc_ruler_object_path_,
-                                 ipc_ruler_interface_name_, consts::register_signal.data(), name, description,
-                                 static_cast<uint8_t>(type));
+  enqueue_registration(&registration_batch::signals,
+                       registration_t{ std::string{ name }, std::string{ description }, static_cast<uint8_t>(type) },
+                       std::move(handler));
 }
 auto ipc_manager_client::register_slot(const std::string_view name,
                                        const std::string_view description,
                                        ipc::details::type_e type,
                                        std::function<void(std::error_code const&)>&& handler) -> void {
-  connection_->async_method_call(std::move(handler), ipc_ruler_service_name_, ipc_ruler_object_path_,
-                                 ipc_ruler_interface_name_, "RegisterSlot", name, description, static_cast<uint8_t>(type));
+  enqueue_registration(&registration_batch::slots,
+                       registration_t{ std::string{ name }, std::string{ description }, static_cast<uint8_t>(type) },
+                       std::move(handler));
+}
+auto ipc_manager_client::enqueue_registration(std::vector<registration_t> registration_batch::*list,
+                                              registration_t registration,
+                                              std::function<void(std::error_code const&)>&& handler) -> void {
+  auto& batch{ *registrations_ };
+  (batch.*list).emplace_back(std::move(registration));
+  batch.handlers.emplace_back(std::move(handler));
+  if (std::exchange(batch.flush_posted, true)) {
+    return;
+  }
+  // Every signal and slot constructed until the posted flush runs joins this batch
+  asio::post(connection_->get_io_context(), [batch_ptr = registrations_, connection = connection_,
+                                             service = ipc_ruler_service_name_, path = ipc_ruler_object_path_,
+                                             interface = ipc_ruler_interface_name_] {
+    auto pending{ std::exchange(*batch_ptr, registration_batch{}) };
+    connection->async_method_call(
+        [handlers = std::move(pending.handlers)](std::error_code const& err) {
+          for (auto const& handler : handlers) {
+            if (handler) {
+              std::invoke(handler, err);
+            }
+          }
+        },
+        service, path, interface, consts::register_many.data(), pending.signals, pending.slots);
+  });
 }
 auto ipc_manager_client::signals(std::function<void(std::vector<signal> const&)>&& handler) -> void {
   sdbusplus::asio::getProperty<std::string>(
@@ -68,6 +125,59 @@ auto ipc_manager_client::signals(std::function<void(std::vector<signal> const&)>
         }
       });
 }
+auto ipc_manager_client::directory() -> ipc_ruler::directory& {
+  if (!std::exchange(directory_->subscribed, true)) {
+    // Clients which never use the directory are not woken up by the changes to the lists
+    make_directory_matches();
+    synchronize_directory();
+  }
+  return directory_->directory;
+}
+auto ipc_manager_client::make_directory_matches() -> void {
+  auto callback{ std::bind_front(&ipc_manager_client::directory_change, this) };
+  directory_matches_.emplace_back(make_match(ruler_signal_match_rule<consts::signal_added>(), callback));
+  directory_matches_.emplace_back(make_match(ruler_signal_match_rule<consts::slot_added>(), callback));
+  directory_matches_.emplace_back(make_match(ruler_signal_match_rule<consts::connection_changed>(), callback));
+  directory_matches_.emplace_back(make_match(ruler_signal_match_rule<consts::directory_reset>(), callback));
+}
+auto ipc_manager_client::synchronize_directory() -> void {
+  directory_->synchronizing = true;
+  using properties_t = std::vector<std::pair<std::string, std::variant<std::string, std::uint64_t>>>;
+  // GetAll reads the lists together with the generation they are at
+  sdbusplus::asio::getAllProperties(
+      *connection_, ipc_ruler_service_name_, ipc_ruler_object_path_, ipc_ruler_interface_name_,
+      [state_ptr = std::weak_ptr{ directory_ }](const boost::system::error_code& error, properties_t const& properties) {
+        auto const state{ state_ptr.lock() };
+        if (!state) {
+          return;
+        }
+        state->synchronizing = false;
+        if (error) {
+          // The directory stays unsynchronized, the next change from the ipc manager reads it again
+          return;
+        }
+        std::uint64_t generation{};
+        std::vector<signal> signals{};
+        std::vector<slot> slots{};
+        bool parsed{ true };
+        for (auto const& [name, value] : properties) {
+          if (name == consts::generation_property) {
+            auto const* number{ std::get_if<std::uint64_t>(&value) };
+            parsed = parsed && number != nullptr;
+            generation = number != nullptr ? *number : 0;
+          } else if (auto const* json{ std::get_if<std::string>(&value) }; json != nullptr) {
+            if (name == consts::signals_property) {
+              parsed = parsed && !glz::read_json(signals, *json);
+            } else if (name == consts::slots_property) {
+              parsed = parsed && !glz::read_json(slots, *json);
+            }
+          }
+        }
+        if (parsed) {
+          state->directory.assign(generation, std::move(signals), std::move(slots));
+        }
+      });
+}
 auto ipc_manager_client::slots(std::function<void(std::vector<slot> const&)>&& handler) -> void {
   sdbusplus::asio::getProperty<std::string>(
       *connection_, ipc_ruler_service_name_, ipc_ruler_object_path_, ipc_ruler_interface_name_,
@@ -134,4 +244,31 @@ auto ipc_manager_client::match_callback(sdbusplus::message_t& msg) -> void {
   }
 }
 
+auto ipc_manager_client::directory_change(sdbusplus::message_t& msg) -> void {
+  std::string_view const member{ msg.get_member() };
+  auto& state{ *directory_ };
+  // Changes emitted before the GetAll reply are included in it and arrive before it
+  if (!state.subscribed || state.synchronizing) {
+    return;
+  }
+  bool applied{ true };
+  if (member == consts::signal_added) {
+    auto const [generation, json]{ msg.unpack<std::tuple<std::uint64_t, std::string>>() };
+    auto entry{ glz::read_json<signal>(json) };
+    applied = entry.has_value() && state.directory.apply_signal(generation, std::move(entry.value()));
+  } else if (member == consts::slot_added) {
+    auto const [generation, json]{ msg.unpack<std::tuple<std::uint64_t, std::string>>() };
+    auto entry{ glz::read_json<slot>(json) };
+    applied = entry.has_value() && state.directory.apply_slot(generation, std::move(entry.value()));
+  } else if (member == consts::connection_changed) {
+    auto const [generation, slot_name, signal_name]{ msg.unpack<std::tuple<std::uint64_t, std::string, std::string>>() };
+    applied = state.directory.apply_connection(generation, slot_name, signal_name);
+  } else if (member == consts::directory_reset) {
+    applied = false;
+  }
+  if (!applied) {
+    synchronize_directory();
+  }
+}
+
 }  // namespace tfc::ipc_ruler
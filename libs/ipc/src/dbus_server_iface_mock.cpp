@@ -27,6 +27,9 @@ void ipc_manager_client_mock::register_slot(std::string_view name, std::string_v
                             .modified_by = "",
                             .connected_to = "",
                             .description = std::string(description) });
+  if (directory_.synchronized()) {
+    [[maybe_unused]] auto const applied{ directory_.apply_slot(directory_.generation() + 1, slots_.back()) };
+  }
 }
 void ipc_manager_client_mock::register_signal(std::string_view name,
                                               std::string_view description,
@@ -38,12 +41,21 @@ void ipc_manager_client_mock::register_signal(std::string_view name,
                                 .created_at = now,
                                 .last_registered = now,
                                 .description = std::string(description) });
+  if (directory_.synchronized()) {
+    [[maybe_unused]] auto const applied{ directory_.apply_signal(directory_.generation() + 1, signals_.back()) };
+  }
 
   sdbusplus::message_t dbus_message = sdbusplus::message_t{};
   for (auto& callback : callbacks_) {
     callback(dbus_message);
   }
 }
+auto ipc_manager_client_mock::directory() -> ipc_ruler::directory& {
+  if (!directory_.synchronized()) {
+    directory_.assign(0, signals_, slots_);
+  }
+  return directory_;
+}
 auto ipc_manager_client_mock::register_properties_change_callback(
     std::function<void(sdbusplus::message_t&)> const& property_callback) -> std::unique_ptr<sdbusplus::bus::match::match> {
   callbacks_.emplace_back(property_callback);
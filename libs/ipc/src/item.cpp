@@ -30,6 +30,12 @@ auto make() -> item {
 auto item::from_json(std::string_view json) -> std::expected<item, glz::parse_error> {
   return glz::read_json<item>(json);
 }
+auto item::validate(std::string_view json, item& buffer) -> std::expected<void, glz::parse_error> {
+  if (auto error{ glz::read_json(buffer, json) }) {
+    return std::unexpected(error);
+  }
+  return {};
+}
 auto item::to_json() const -> std::string {
   return glz::write_json(*this);
 }
@@ -0,0 +1,195 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <boost/ut.hpp>
+
+#include <tfc/ipc/details/connection_index.hpp>
+#include <tfc/ipc/details/dbus_structs.hpp>
+#include <tfc/progbase.hpp>
+
+namespace ut = boost::ut;
+
+// Count every heap allocation made through operator new in this process
+static std::atomic<std::size_t> allocations{ 0 };  // NOLINT
+
+auto operator new(std::size_t size) -> void* {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size)) {  // NOLINT
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);  // NOLINT
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);  // NOLINT
+}
+
+namespace {
+constexpr std::size_t signal_count{ 10'000 };
+constexpr std::size_t slot_count{ 20'000 };
+constexpr std::size_t iterations{ 100'000 };
+
+using tfc::ipc::details::type_e;
+using tfc::ipc_ruler::connection_index;
+
+struct result {
+  std::size_t allocations{};
+  std::chrono::nanoseconds per_op{};
+};
+
+auto measure(std::size_t warmup_iterations, auto&& operation) -> result {
+  for (std::size_t idx = 0; idx < warmup_iterations; idx++) {
+    operation(idx);
+  }
+  auto const allocations_before{ allocations.load() };
+  auto const start{ std::chrono::steady_clock::now() };
+  for (std::size_t idx = 0; idx < iterations; idx++) {
+    operation(idx);
+  }
+  auto const elapsed{ std::chrono::steady_clock::now() - start };
+  return { .allocations = allocations.load() - allocations_before,
+           .per_op = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed) / iterations };
+}
+
+// Names the length of those of a real deployment, longer than the small string buffer
+auto signal_name(std::size_t idx) -> std::string {
+  return fmt::format("tfc.benchmark.def.{}.signal_{:05}", idx % 2 == 0 ? "bool" : "int64_t", idx);
+}
+auto slot_name(std::size_t idx) -> std::string {
+  return fmt::format("tfc.benchmark.def.{}.slot_{:05}", idx % 2 == 0 ? "bool" : "int64_t", idx);
+}
+auto type_of(std::size_t idx) -> type_e {
+  return idx % 2 == 0 ? type_e::_bool : type_e::_int64_t;
+}
+
+/// \brief storages of the ipc ruler, slot idx connected to signal idx % signal_count
+struct storages {
+  std::map<std::string, tfc::ipc_ruler::signal, std::less<>> signals{};
+  std::map<std::string, tfc::ipc_ruler::slot, std::less<>> slots{};
+  std::vector<std::string> signal_names{};
+  std::vector<std::string> slot_names{};
+
+  storages() {
+    for (std::size_t idx = 0; idx < signal_count; idx++) {
+      auto name{ signal_name(idx) };
+      auto& entry{ signals[name] };
+      entry.name = name;
+      entry.type = type_of(idx);
+      signal_names.emplace_back(std::move(name));
+    }
+    for (std::size_t idx = 0; idx < slot_count; idx++) {
+      auto name{ slot_name(idx) };
+      auto& entry{ slots[name] };
+      entry.name = name;
+      entry.type = type_of(idx);
+      entry.connected_to = signal_names[idx % signal_count];
+      slot_names.emplace_back(std::move(name));
+    }
+  }
+};
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  tfc::base::init(argc, argv);
+  using ut::operator""_test;
+
+  storages const data{};
+  connection_index index{};
+  index.rebuild(data.signals, data.slots);
+  auto const reconnect_all{ [&] {
+    for (std::size_t idx = 0; idx < slot_count; idx++) {
+      index.connect(data.slot_names[idx], data.signal_names[idx % signal_count]);
+    }
+  } };
+
+  "reconnecting a slot does not allocate"_test = [&] {
+    // Each slot moves to the next signal of its type and back, a full round trip of every slot is made as warm up
+    auto const reconnect{ [&](std::size_t idx) {
+      auto const slot{ idx % slot_count };
+      auto const signal{ (slot + ((idx / slot_count) % 2 == 0 ? 2 : 0)) % signal_count };
+      index.connect(data.slot_names[slot], data.signal_names[signal]);
+    } };
+    auto const res{ measure(2 * slot_count, reconnect) };
+    fmt::print("connect            {:>6} ns/op {:>6} allocations\n", res.per_op.count(), res.allocations);
+    ut::expect(res.allocations == 0);
+    // the last round moved every slot on
+    ut::expect(index.connected_to(data.slot_names[3]) == data.signal_names[5]);
+    ut::expect(index.slots_of(data.signal_names[5]).size() == 2);
+    reconnect_all();
+  };
+
+  "disconnecting and connecting a slot does not allocate"_test = [&] {
+    auto const toggle{ [&](std::size_t idx) {
+      auto const slot{ idx % slot_count };
+      if ((idx / slot_count) % 2 == 0) {
+        index.disconnect(data.slot_names[slot]);
+      } else {
+        index.connect(data.slot_names[slot], data.signal_names[slot % signal_count]);
+      }
+    } };
+    auto const res{ measure(2 * slot_count, toggle) };
+    fmt::print("disconnect/connect {:>6} ns/op {:>6} allocations\n", res.per_op.count(), res.allocations);
+    ut::expect(res.allocations == 0);
+    reconnect_all();
+  };
+
+  "slots of a signal from the index"_test = [&] {
+    std::size_t found{};
+    auto const res{ measure(signal_count, [&](std::size_t idx) {
+      found += index.slots_of(data.signal_names[idx % signal_count]).size();
+    }) };
+    fmt::print("slots_of index     {:>6} ns/op {:>6} allocations\n", res.per_op.count(), res.allocations);
+    ut::expect(found == 2 * (iterations + signal_count));
+    ut::expect(res.allocations == 0);
+  };
+
+  "slots of a signal by scanning the slot storage for reference"_test = [&] {
+    // How the slots of a signal were found before the index, a few rounds suffice
+    constexpr std::size_t rounds{ 100 };
+    std::size_t found{};
+    auto const start{ std::chrono::steady_clock::now() };
+    for (std::size_t idx = 0; idx < rounds; idx++) {
+      auto const& name{ data.signal_names[idx] };
+      for (auto const& [key, slot] : data.slots) {
+        found += slot.connected_to == name ? 1 : 0;
+      }
+    }
+    auto const per_op{ std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start) /
+                       rounds };
+    fmt::print("slots_of scan      {:>6} ns/op\n", per_op.count());
+    ut::expect(found == 2 * rounds);
+  };
+
+  "signals a slot can connect to"_test = [&] {
+    std::size_t found{};
+    auto const res{ measure(0, [&](std::size_t idx) {
+      found += index.signals_of_type(index.slot_type(data.slot_names[idx % slot_count]).value()).size();
+    }) };
+    fmt::print("signals_of_type    {:>6} ns/op {:>6} allocations\n", res.per_op.count(), res.allocations);
+    ut::expect(found == iterations * signal_count / 2);
+    ut::expect(res.allocations == 0);
+  };
+
+  "every connection"_test = [&] {
+    std::size_t connected{};
+    auto const start{ std::chrono::steady_clock::now() };
+    index.for_each_connection(
+        [&connected](std::string_view, std::span<std::string_view const> slots) { connected += slots.size(); });
+    auto const elapsed{ std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) };
+    fmt::print("for_each_connection {:>5} us\n", elapsed.count());
+    ut::expect(connected == slot_count);
+  };
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <boost/asio.hpp>
+#include <boost/ut.hpp>
+#include <glaze/glaze.hpp>
+
+#include <tfc/ipc/details/filter.hpp>
+#include <tfc/progbase.hpp>
+#include <tfc/stx/small_function.hpp>
+
+namespace asio = boost::asio;
+namespace ut = boost::ut;
+
+// Count every heap allocation made through operator new in this process
+static std::atomic<std::size_t> allocations{ 0 };  // NOLINT
+
+auto operator new(std::size_t size) -> void* {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size)) {  // NOLINT
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);  // NOLINT
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);  // NOLINT
+}
+
+namespace {
+constexpr std::size_t warmup_iterations{ 100 };
+constexpr std::size_t iterations{ 100'000 };
+
+struct result {
+  std::size_t allocations{};
+  std::chrono::nanoseconds per_op{};
+};
+
+auto measure(auto&& operation) -> result {
+  for (std::size_t idx = 0; idx < warmup_iterations; idx++) {
+    operation(idx);
+  }
+  auto const allocations_before{ allocations.load() };
+  auto const start{ std::chrono::steady_clock::now() };
+  for (std::size_t idx = 0; idx < iterations; idx++) {
+    operation(idx);
+  }
+  auto const elapsed{ std::chrono::steady_clock::now() - start };
+  return { .allocations = allocations.load() - allocations_before,
+           .per_op = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed) / iterations };
+}
+
+using value_t = std::int64_t;
+using any_filter_t = tfc::ipc::filter::detail::any_filter_decl_t<value_t>;
+using tfc::ipc::filter::filter;
+using tfc::ipc::filter::filter_e;
+
+auto make_chain() -> std::vector<any_filter_t> {
+  return { filter<filter_e::offset, value_t>{ .offset = 2 }, filter<filter_e::multiply, value_t>{ .multiply = 3 } };
+}
+
+/// \brief the way the chain was processed before the fused path, one coroutine per value
+auto coroutine_chain(std::vector<any_filter_t> const& chain, value_t value) -> asio::awaitable<value_t> {
+  std::expected<value_t, std::error_code> return_val{ value };
+  for (auto const& filter : chain) {
+    return_val = co_await std::visit(
+        [return_v = std::move(return_val)](auto&& arg) mutable -> auto {
+          return arg.async_process(std::move(return_v.value()), asio::use_awaitable);
+        },
+        filter);
+  }
+  co_return return_val.value_or(0);
+}
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  tfc::base::init(argc, argv);
+  using ut::operator""_test;
+
+  "synchronous filter chain is evaluated inline without allocating"_test = [] {
+    asio::io_context ctx{};
+    std::string_view const name{ "filter_benchmark.fused" };
+    // the filters are read from their configuration file when constructed
+    auto const config_file{ tfc::base::make_config_file_name(fmt::format("{}._filters_", name), "json") };
+    std::filesystem::create_directories(config_file.parent_path());
+    std::ofstream{ config_file } << glz::write_json(make_chain());
+
+    value_t sum{};
+    using callback_t = tfc::stx::small_function<void(value_t&)>;
+    tfc::ipc::filter::filters<value_t, callback_t> filters{ ctx, name,
+                                                            callback_t{ [&sum](value_t& value) { sum += value; } } };
+    auto const res{ measure([&filters](std::size_t idx) { filters(static_cast<value_t>(idx)); }) };
+    fmt::print("filters   {:<18} {:>6} ns/op {:>6} allocations\n", "offset,multiply", res.per_op.count(), res.allocations);
+    ut::expect(sum != 0);
+    ut::expect(res.allocations == 0);
+    std::filesystem::remove(config_file);
+  };
+
+  "coroutine filter chain for reference"_test = [] {
+    asio::io_context ctx{};
+    auto const chain{ make_chain() };
+    value_t sum{};
+    auto const res{ measure([&](std::size_t idx) {
+      asio::co_spawn(ctx, coroutine_chain(chain, static_cast<value_t>(idx)),
+                     [&sum](std::exception_ptr const&, value_t value) { sum += value; });
+      ctx.poll();
+      ctx.restart();
+    }) };
+    fmt::print("coroutine {:<18} {:>6} ns/op {:>6} allocations\n", "offset,multiply", res.per_op.count(), res.allocations);
+    ut::expect(sum != 0);
+  };
+
+  "lambda filter compared to the native filters it replaces"_test = [] {
+    filter<filter_e::offset, value_t> const offset{ .offset = 2 };
+    filter<filter_e::multiply, value_t> const multiply{ .multiply = 3 };
+    value_t native_sum{};
+    auto const native{ measure([&](std::size_t idx) {
+      native_sum += multiply.process(offset.process(static_cast<value_t>(idx)).value()).value();
+    }) };
+    fmt::print("native    {:<18} {:>6} ns/op {:>6} allocations\n", "offset,multiply", native.per_op.count(),
+               native.allocations);
+
+    filter<filter_e::lambda, value_t> lambda{};
+    lambda.lambda = std::string{ "(x + 2) * 3" };
+    value_t lambda_sum{};
+    auto const compiled{ measure([&](std::size_t idx) {
+      lambda_sum += lambda.process(static_cast<value_t>(idx)).value();
+    }) };
+    fmt::print("lambda    {:<18} {:>6} ns/op {:>6} allocations\n", "(x + 2) * 3", compiled.per_op.count(),
+               compiled.allocations);
+    ut::expect(lambda_sum == native_sum);
+    ut::expect(compiled.allocations == 0);
+  };
+
+  return 0;
+}
@@ -0,0 +1,581 @@
+// Signal to slot throughput and latency benchmarks, results are written as json for regression tracking.
+//
+// tfc_ipc_benchmarks --iterations 10000 --subscribers 1 4 16 --output results.json
+//
+// Latency is measured from the send timestamp of the v1 header to the completion of the receive, so the in process
+// and cross process numbers are comparable. Values are sent in windows which are awaited before the next window is
+// sent, the window is kept below the zmq high water mark so no value is dropped.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/program_options.hpp>
+#include <glaze/glaze.hpp>
+#include <sdbusplus/asio/connection.hpp>
+
+#include <tfc/ipc.hpp>
+#include <tfc/ipc/details/filter.hpp>
+#include <tfc/ipc/details/statistics.hpp>
+#include <tfc/progbase.hpp>
+
+namespace asio = boost::asio;
+namespace bpo = boost::program_options;
+namespace details = tfc::ipc::details;
+
+extern char** environ;  // NOLINT
+
+namespace {
+
+struct options {
+  std::size_t iterations{};
+  std::size_t window{};
+  std::vector<std::size_t> subscribers{};
+  std::vector<std::size_t> payload_sizes{};
+  bool cross_process{};
+  bool dbus{};
+};
+
+struct case_result {
+  std::string name{};
+  std::string type{};
+  std::size_t payload_size{};
+  std::size_t subscribers{};
+  std::size_t messages{};
+  double messages_per_second{};
+  std::uint64_t p50_ns{};
+  std::uint64_t p99_ns{};
+  std::uint64_t p999_ns{};
+  std::string error{};
+
+  struct glaze {
+    using type = case_result;
+    // clang-format off
+    static constexpr auto value{ glz::object(
+        "name", &type::name,
+        "type", &type::type,
+        "payload_size", &type::payload_size,
+        "subscribers", &type::subscribers,
+        "messages", &type::messages,
+        "messages_per_second", &type::messages_per_second,
+        "p50_ns", &type::p50_ns,
+        "p99_ns", &type::p99_ns,
+        "p999_ns", &type::p999_ns,
+        "error", &type::error) };
+    // clang-format on
+  };
+};
+
+constexpr auto receive_timeout{ std::chrono::seconds{ 5 } };
+
+void summarize(case_result& result, std::vector<std::uint64_t>& latencies, std::chrono::nanoseconds elapsed) {
+  result.messages = latencies.size();
+  if (elapsed.count() > 0) {
+    result.messages_per_second = static_cast<double>(latencies.size()) * 1e9 / static_cast<double>(elapsed.count());
+  }
+  if (latencies.empty()) {
+    return;
+  }
+  std::ranges::sort(latencies);
+  auto const at{ [&latencies](double quantile) {
+    return latencies[static_cast<std::size_t>(quantile * static_cast<double>(latencies.size() - 1))];
+  } };
+  result.p50_ns = at(0.5);
+  result.p99_ns = at(0.99);
+  result.p999_ns = at(0.999);
+}
+
+void report(case_result const& result) {
+  fmt::print(stderr, "{:<14} {:<7} {:>6} B {:>3} subs {:>12.0f} msg/s p50 {:>8} ns p99 {:>8} ns p999 {:>8} ns {}\n",
+             result.name, result.type, result.payload_size, result.subscribers, result.messages_per_second, result.p50_ns,
+             result.p99_ns, result.p999_ns, result.error);
+}
+
+/// \brief value number idx of the given payload size, consecutive values differ
+template <typename type_desc>
+auto make_value(std::size_t idx, std::string const& payload) -> typename type_desc::value_t {
+  using value_t = typename type_desc::value_t;
+  if constexpr (std::same_as<value_t, bool>) {
+    return idx % 2 == 0;
+  } else if constexpr (std::same_as<value_t, std::string>) {
+    return payload;
+  } else {
+    return static_cast<value_t>(idx);
+  }
+}
+
+/// \return payload of approximately size bytes, valid json for the json type
+template <typename type_desc>
+auto make_payload(std::size_t size) -> std::string {
+  if constexpr (type_desc::value_e == details::type_e::_json) {
+    constexpr std::string_view overhead{ R"({"data":""})" };
+    return fmt::format(R"({{"data":"{}"}})", std::string(size > overhead.size() ? size - overhead.size() : 0, 'x'));
+  } else {
+    return std::string(size, 'x');
+  }
+}
+
+template <typename type_desc>
+constexpr auto payload_size_of(std::string const& payload) -> std::size_t {
+  if constexpr (std::same_as<typename type_desc::value_t, std::string>) {
+    return payload.size();
+  } else {
+    return sizeof(typename type_desc::value_t);
+  }
+}
+
+/// \brief slots receiving from one signal, recording the latency of each value
+template <typename type_desc>
+class receivers {
+public:
+  receivers(asio::io_context& ctx, std::string_view signal_name, std::size_t count, std::size_t capacity) {
+    latencies_.reserve(capacity);
+    for (std::size_t idx{ 0 }; idx < count; idx++) {
+      auto& sub{ subscribers_.emplace_back(std::make_unique<subscriber>(
+          details::slot<type_desc>::create(ctx, fmt::format("bench_slot_{}", idx)), typename type_desc::value_t{})) };
+      if (auto err{ sub->slot->connect(signal_name) }) {
+        error_ = err;
+        return;
+      }
+      receive(*sub);
+    }
+  }
+
+  [[nodiscard]] auto received() const noexcept -> std::size_t { return latencies_.size(); }
+  [[nodiscard]] auto error() const noexcept -> std::error_code { return error_; }
+  [[nodiscard]] auto latencies() noexcept -> std::vector<std::uint64_t>& { return latencies_; }
+
+private:
+  struct subscriber {
+    std::shared_ptr<details::slot<type_desc>> slot;
+    typename type_desc::value_t value;
+  };
+
+  void receive(subscriber& sub) {
+    sub.slot->async_receive_into(sub.value, [this, &sub](std::error_code const& err) {
+      if (err) {
+        error_ = err;
+        return;
+      }
+      latencies_.emplace_back(details::monotonic_ns() - sub.slot->last_header().timestamp);
+      receive(sub);
+    });
+  }
+
+  std::vector<std::unique_ptr<subscriber>> subscribers_{};
+  std::vector<std::uint64_t> latencies_{};
+  std::error_code error_{};
+};
+
+/// \brief run ctx until count values have been received
+/// \return false on timeout or receive error
+template <typename type_desc>
+auto await_received(asio::io_context& ctx, receivers<type_desc>& group, std::size_t count) -> bool {
+  auto const deadline{ std::chrono::steady_clock::now() + receive_timeout };
+  while (group.received() < count && !group.error()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    ctx.run_one_for(std::chrono::milliseconds{ 10 });
+  }
+  return !group.error();
+}
+
+/// \brief send options.iterations values, send_window(first, count) sends one window which is awaited before the next
+/// \return elapsed time or an error message
+template <typename type_desc>
+auto run_windows(asio::io_context& ctx,
+                 receivers<type_desc>& group,
+                 options const& opts,
+                 std::size_t subscriber_count,
+                 auto&& send_window) -> std::expected<std::chrono::nanoseconds, std::string> {
+  // every subscriber first receives the snapshot of the signal
+  if (!await_received(ctx, group, subscriber_count)) {
+    return std::unexpected(fmt::format("snapshot not received {}", group.error().message()));
+  }
+  group.latencies().clear();
+  auto const start{ std::chrono::steady_clock::now() };
+  for (std::size_t sent{ 0 }; sent < opts.iterations;) {
+    auto const count{ std::min(opts.window, opts.iterations - sent) };
+    send_window(sent, count);
+    sent += count;
+    if (!await_received(ctx, group, sent * subscriber_count)) {
+      return std::unexpected(fmt::format("received {} of {} {}", group.received(), sent * subscriber_count,
+                                         group.error().message()));
+    }
+  }
+  return std::chrono::steady_clock::now() - start;
+}
+
+template <typename type_desc>
+auto in_process_case(options const& opts, std::size_t payload_size, std::size_t subscriber_count) -> case_result {
+  using value_t = typename type_desc::value_t;
+  auto const payload{ make_payload<type_desc>(payload_size) };
+  case_result result{ .name = "in_process",
+                      .type = std::string{ type_desc::type_name },
+                      .payload_size = payload_size_of<type_desc>(payload),
+                      .subscribers = subscriber_count };
+  asio::io_context ctx{};
+  auto signal{ details::signal<type_desc>::create(ctx, "bench_in_process") };
+  if (!signal) {
+    result.error = signal.error().message();
+    return result;
+  }
+  receivers<type_desc> group{ ctx, signal.value()->name_w_type(), subscriber_count, opts.iterations * subscriber_count };
+  std::vector<value_t> values{};
+  for (std::size_t idx{ 0 }; idx < opts.window; idx++) {
+    values.emplace_back(make_value<type_desc>(idx, payload));
+  }
+  auto elapsed{ run_windows(ctx, group, opts, subscriber_count, [&](std::size_t, std::size_t count) {
+    for (std::size_t idx{ 0 }; idx < count; idx++) {
+      [[maybe_unused]] auto err{ signal.value()->send(values[idx]) };
+    }
+  }) };
+  if (!elapsed) {
+    result.error = elapsed.error();
+    return result;
+  }
+  summarize(result, group.latencies(), elapsed.value());
+  return result;
+}
+
+/// \brief invoke callback with the type description named type_name
+auto with_type(std::string_view type_name, auto&& callback) -> bool {
+  auto const attempt{ [&]<typename type_desc>(type_desc) {
+    if (type_name == type_desc::type_name) {
+      callback(type_desc{});
+      return true;
+    }
+    return false;
+  } };
+  return attempt(details::type_bool{}) || attempt(details::type_int{}) || attempt(details::type_uint{}) ||
+         attempt(details::type_double{}) || attempt(details::type_string{}) || attempt(details::type_json{});
+}
+
+// The sender side of the cross process case, runs in a process of its own spawned by the receiving side.
+// One byte is read from the control pipe before the first window and after each window.
+template <typename type_desc>
+auto cross_process_sender(options const& opts, std::size_t payload_size, int control_fd) -> int {
+  using value_t = typename type_desc::value_t;
+  auto const payload{ make_payload<type_desc>(payload_size) };
+  asio::io_context ctx{};
+  auto signal{ details::signal<type_desc>::create(ctx, "bench_cross_process") };
+  if (!signal) {
+    return EXIT_FAILURE;
+  }
+  std::vector<value_t> values{};
+  for (std::size_t idx{ 0 }; idx < opts.window; idx++) {
+    values.emplace_back(make_value<type_desc>(idx, payload));
+  }
+  fcntl(control_fd, F_SETFL, fcntl(control_fd, F_GETFL) | O_NONBLOCK);  // NOLINT
+  auto const await_go{ [&]() {
+    // keep answering subscriptions while waiting for the receiving side
+    for (;;) {
+      char go{};
+      auto const bytes_read{ read(control_fd, &go, 1) };
+      if (bytes_read == 1) {
+        return true;
+      }
+      if (bytes_read == 0 || errno != EAGAIN) {
+        return false;  // the receiving side has gone away
+      }
+      ctx.run_one_for(std::chrono::milliseconds{ 1 });
+    }
+  } };
+  if (!await_go()) {
+    return EXIT_FAILURE;
+  }
+  for (std::size_t sent{ 0 }; sent < opts.iterations;) {
+    auto const count{ std::min(opts.window, opts.iterations - sent) };
+    for (std::size_t idx{ 0 }; idx < count; idx++) {
+      [[maybe_unused]] auto err{ signal.value()->send(values[idx]) };
+    }
+    sent += count;
+    if (!await_go()) {
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+template <typename type_desc>
+auto cross_process_case(options const& opts, std::size_t payload_size, std::size_t subscriber_count) -> case_result {
+  auto const payload{ make_payload<type_desc>(payload_size) };
+  case_result result{ .name = "cross_process",
+                      .type = std::string{ type_desc::type_name },
+                      .payload_size = payload_size_of<type_desc>(payload),
+                      .subscribers = subscriber_count };
+  std::array<int, 2> control{};
+  if (pipe(control.data()) != 0) {
+    result.error = "pipe failed";
+    return result;
+  }
+  auto const executable{ std::filesystem::read_symlink("/proc/self/exe").string() };
+  std::vector<std::string> arguments{ executable,
+                                      "--id",
+                                      std::string{ tfc::base::get_proc_name() },
+                                      "--role",
+                                      "sender",
+                                      "--type",
+                                      std::string{ type_desc::type_name },
+                                      "--payload-sizes",
+                                      std::to_string(payload_size),
+                                      "--iterations",
+                                      std::to_string(opts.iterations),
+                                      "--window",
+                                      std::to_string(opts.window),
+                                      "--control-fd",
+                                      std::to_string(control[0]) };
+  std::vector<char*> argv{};
+  for (auto& argument : arguments) {
+    argv.emplace_back(argument.data());
+  }
+  argv.emplace_back(nullptr);
+  pid_t child{};
+  if (posix_spawn(&child, executable.c_str(), nullptr, nullptr, argv.data(), environ) != 0) {
+    result.error = "spawn failed";
+    close(control[0]);
+    close(control[1]);
+    return result;
+  }
+  close(control[0]);
+
+  asio::io_context ctx{};
+  // the name of the signal in the child process, it shares executable and process name with this one
+  auto const signal_name{ details::transmission_base<type_desc>{ "bench_cross_process" }.name_w_type() };
+  receivers<type_desc> group{ ctx, signal_name, subscriber_count, opts.iterations * subscriber_count };
+  auto elapsed{ std::chrono::nanoseconds{} };
+  // the first go is written once the snapshots have arrived
+  if (!await_received(ctx, group, subscriber_count)) {
+    result.error = "snapshot not received";
+  } else {
+    group.latencies().clear();
+    constexpr char go{ 1 };
+    auto const start{ std::chrono::steady_clock::now() };
+    for (std::size_t sent{ 0 }; sent < opts.iterations && result.error.empty();) {
+      [[maybe_unused]] auto written{ write(control[1], &go, 1) };
+      sent += std::min(opts.window, opts.iterations - sent);
+      if (!await_received(ctx, group, sent * subscriber_count)) {
+        result.error = fmt::format("received {} of {}", group.received(), sent * subscriber_count);
+      }
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    [[maybe_unused]] auto written{ write(control[1], &go, 1) };
+  }
+  close(control[1]);
+  int status{};
+  waitpid(child, &status, 0);
+  summarize(result, group.latencies(), elapsed);
+  return result;
+}
+
+/// \brief the filter pipeline of a slot, an empty chain and a chain of offset and multiply
+/// The value sent is the send timestamp, so the latency covers receive, filters and callback.
+auto filter_cases(options const& opts, std::size_t subscriber_count) -> std::vector<case_result> {
+  using value_t = std::int64_t;
+  using filter_variant = tfc::ipc::filter::detail::any_filter_decl_t<value_t>;
+  using tfc::ipc::filter::filter;
+  using tfc::ipc::filter::filter_e;
+
+  std::vector<case_result> results{};
+  auto const run{ [&](std::string_view case_name, std::vector<filter_variant> const& chain) {
+    case_result result{ .name = std::string{ case_name },
+                        .type = std::string{ details::type_int::type_name },
+                        .payload_size = sizeof(value_t),
+                        .subscribers = subscriber_count };
+    asio::io_context ctx{};
+    auto signal{ details::signal<details::type_int>::create(ctx, fmt::format("bench_{}", case_name)) };
+    if (!signal) {
+      result.error = signal.error().message();
+      results.emplace_back(result);
+      return;
+    }
+    std::vector<std::uint64_t> latencies{};
+    latencies.reserve(opts.iterations * subscriber_count);
+    std::vector<std::shared_ptr<details::slot_callback<details::type_int>>> slots{};
+    std::vector<std::filesystem::path> config_files{};
+    for (std::size_t idx{ 0 }; idx < subscriber_count; idx++) {
+      auto const slot_name{ fmt::format("bench_{}_{}", case_name, idx) };
+      // the filters of a slot are read from its configuration file when constructed
+      auto const config_file{ tfc::base::make_config_file_name(
+          fmt::format("{}.{}._filters_", details::type_int::type_name, slot_name), "json") };
+      std::filesystem::create_directories(config_file.parent_path());
+      std::ofstream{ config_file } << glz::write_json(chain);
+      config_files.emplace_back(config_file);
+      auto& slot{ slots.emplace_back(details::slot_callback<details::type_int>::create(
+          ctx, slot_name, [&latencies](value_t value) {
+            latencies.emplace_back(details::monotonic_ns() - static_cast<std::uint64_t>(value));
+          })) };
+      if (auto err{ slot->connect(signal.value()->name_w_type()) }) {
+        result.error = err.message();
+      }
+    }
+    auto const await{ [&](std::size_t count) {
+      auto const deadline{ std::chrono::steady_clock::now() + receive_timeout };
+      while (latencies.size() < count && std::chrono::steady_clock::now() < deadline) {
+        ctx.run_one_for(std::chrono::milliseconds{ 10 });
+      }
+      return latencies.size() >= count;
+    } };
+    // the snapshot is the default value zero, its latency is meaningless
+    [[maybe_unused]] auto const snapshots{ await(subscriber_count) };
+    latencies.clear();
+    auto const start{ std::chrono::steady_clock::now() };
+    for (std::size_t sent{ 0 }; sent < opts.iterations && result.error.empty();) {
+      auto const count{ std::min(opts.window, opts.iterations - sent) };
+      for (std::size_t idx{ 0 }; idx < count; idx++) {
+        [[maybe_unused]] auto err{ signal.value()->send(static_cast<value_t>(details::monotonic_ns())) };
+      }
+      sent += count;
+      if (!await(sent * subscriber_count)) {
+        result.error = fmt::format("received {} of {}", latencies.size(), sent * subscriber_count);
+      }
+    }
+    summarize(result, latencies, std::chrono::steady_clock::now() - start);
+    for (auto const& config_file : config_files) {
+      std::filesystem::remove(config_file);
+    }
+    results.emplace_back(result);
+  } };
+  run("filters_empty", {});
+  run("filters_chain",
+      { filter<filter_e::offset, value_t>{ .offset = 0 }, filter<filter_e::multiply, value_t>{ .multiply = 1 } });
+  return results;
+}
+
+/// \brief cost of emitting a value as a dbus property change, the latency is the cost of one emission
+/// \param policy max_rate shows the cost of a value which is coalesced instead of emitted
+template <typename type_desc>
+auto dbus_case(options const& opts, std::string const& payload, details::emit_policy policy = {}) -> case_result {
+  using value_t = typename type_desc::value_t;
+  case_result result{ .name = policy.policy == details::emit_policy_e::every ? "dbus_emit" : "dbus_emit_coalesced",
+                      .type = std::string{ type_desc::type_name },
+                      .payload_size = payload_size_of<type_desc>(payload),
+                      .subscribers = 0 };
+  try {
+    asio::io_context ctx{};
+    std::optional<value_t> last_value{};
+    details::dbus_slot<value_t> dbus_slot{ std::make_shared<sdbusplus::asio::connection>(ctx) };
+    dbus_slot.initialize(fmt::format("bench_dbus_{}", type_desc::type_name));
+    dbus_slot.set_emit_policy(policy, ctx.get_executor());
+    // emissions are not flow controlled, keep the count modest
+    auto const count{ std::min<std::size_t>(opts.iterations, 10'000) };
+    std::vector<std::uint64_t> latencies{};
+    latencies.reserve(count);
+    auto const start{ std::chrono::steady_clock::now() };
+    for (std::size_t idx{ 0 }; idx < count; idx++) {
+      last_value = make_value<type_desc>(idx, payload);
+      auto const before{ details::monotonic_ns() };
+      dbus_slot.emit_value(last_value.value());
+      latencies.emplace_back(details::monotonic_ns() - before);
+      ctx.poll();
+    }
+    summarize(result, latencies, std::chrono::steady_clock::now() - start);
+  } catch (std::exception const& exception) {
+    result.error = exception.what();
+  }
+  return result;
+}
+
+template <typename type_desc>
+void type_cases(options const& opts, std::vector<case_result>& results) {
+  std::vector<std::size_t> payload_sizes{ opts.payload_sizes };
+  if constexpr (!std::same_as<typename type_desc::value_t, std::string>) {
+    payload_sizes = { sizeof(typename type_desc::value_t) };
+  }
+  for (auto const payload_size : payload_sizes) {
+    for (auto const subscriber_count : opts.subscribers) {
+      report(results.emplace_back(in_process_case<type_desc>(opts, payload_size, subscriber_count)));
+      if (opts.cross_process) {
+        report(results.emplace_back(cross_process_case<type_desc>(opts, payload_size, subscriber_count)));
+      }
+    }
+    if (opts.dbus) {
+      report(results.emplace_back(dbus_case<type_desc>(opts, make_payload<type_desc>(payload_size))));
+      details::emit_policy const coalesced{ .policy = details::emit_policy_e::max_rate,
+                                            .interval = std::chrono::milliseconds{ 100 } };
+      report(results.emplace_back(dbus_case<type_desc>(opts, make_payload<type_desc>(payload_size), coalesced)));
+    }
+  }
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  options opts{};
+  std::string output{};
+  std::string role{};
+  std::string type_name{};
+  int control_fd{ -1 };
+  auto desc{ tfc::base::default_description() };
+  // clang-format off
+  desc.add_options()
+      ("iterations", bpo::value<std::size_t>(&opts.iterations)->default_value(10'000), "Values sent per case.")
+      ("window", bpo::value<std::size_t>(&opts.window)->default_value(100),
+          "Values in flight, below the zmq high water mark.")
+      ("subscribers",
+          bpo::value<std::vector<std::size_t>>(&opts.subscribers)->multitoken()->default_value({ 1, 4, 16 }, "1 4 16"),
+          "Subscriber counts.")
+      ("payload-sizes",
+          bpo::value<std::vector<std::size_t>>(&opts.payload_sizes)->multitoken()
+              ->default_value({ 16, 256, 4096, 65536 }, "16 256 4096 65536"),
+          "Payload sizes of string and json.")
+      ("cross-process", bpo::value<bool>(&opts.cross_process)->default_value(true), "Run cross process cases.")
+      ("dbus", bpo::value<bool>(&opts.dbus)->default_value(true), "Run dbus emission cases, requires a bus.")
+      ("output", bpo::value<std::string>(&output)->default_value("-"), "Json result file, - for stdout.")
+      ("role", bpo::value<std::string>(&role)->default_value("receiver"), "Internal, sender of a cross process case.")
+      ("type", bpo::value<std::string>(&type_name), "Internal, type of a cross process case.")
+      ("control-fd", bpo::value<int>(&control_fd), "Internal, pipe pacing a cross process case.");
+  // clang-format on
+  tfc::base::init(argc, argv, desc);
+
+  if (role == "sender") {
+    int exit_code{ EXIT_FAILURE };
+    auto const payload_size{ opts.payload_sizes.empty() ? std::size_t{ 0 } : opts.payload_sizes.front() };
+    with_type(type_name, [&]<typename type_desc>(type_desc) {
+      exit_code = cross_process_sender<type_desc>(opts, payload_size, control_fd);
+    });
+    return exit_code;
+  }
+
+  std::vector<case_result> results{};
+  type_cases<details::type_bool>(opts, results);
+  type_cases<details::type_int>(opts, results);
+  type_cases<details::type_uint>(opts, results);
+  type_cases<details::type_double>(opts, results);
+  type_cases<details::type_string>(opts, results);
+  type_cases<details::type_json>(opts, results);
+  for (auto const subscriber_count : opts.subscribers) {
+    for (auto const& result : filter_cases(opts, subscriber_count)) {
+      report(results.emplace_back(result));
+    }
+  }
+
+  auto const json{ glz::write_json(results) };
+  if (output == "-") {
+    fmt::print("{}\n", json);
+  } else {
+    std::ofstream{ output } << json;
+  }
+  auto const failed{ std::ranges::any_of(results, [](case_result const& result) {
+    return !result.error.empty() && result.name != "dbus_emit";
+  }) };
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
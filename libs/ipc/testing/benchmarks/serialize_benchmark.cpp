@@ -0,0 +1,187 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include <fmt/core.h>
+#include <boost/asio/io_context.hpp>
+#include <boost/ut.hpp>
+
+#include <tfc/ipc.hpp>
+#include <tfc/ipc/packet.hpp>
+#include <tfc/progbase.hpp>
+
+namespace asio = boost::asio;
+namespace ut = boost::ut;
+
+// Count every heap allocation made in this process. malloc is interposed so allocations of zmq are seen as well as
+// those through operator new, the sanitizers interpose malloc themselves in which case only operator new is counted.
+static std::atomic<std::size_t> allocations{ 0 };  // NOLINT
+
+#if defined(__SANITIZE_ADDRESS__)
+#define TFC_BENCHMARK_SANITIZED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define TFC_BENCHMARK_SANITIZED
+#endif
+#endif
+
+#ifdef TFC_BENCHMARK_SANITIZED
+static constexpr bool counts_malloc{ false };
+
+auto operator new(std::size_t size) -> void* {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size)) {  // NOLINT
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);  // NOLINT
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);  // NOLINT
+}
+#else
+static constexpr bool counts_malloc{ true };
+
+// glibc, operator new of libstdc++ allocates through malloc
+extern "C" {
+auto __libc_malloc(std::size_t size) -> void*;                    // NOLINT
+auto __libc_calloc(std::size_t count, std::size_t size) -> void*;  // NOLINT
+auto __libc_realloc(void* ptr, std::size_t size) -> void*;         // NOLINT
+
+auto malloc(std::size_t size) noexcept -> void* {  // NOLINT
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+auto calloc(std::size_t count, std::size_t size) noexcept -> void* {  // NOLINT
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+auto realloc(void* ptr, std::size_t size) noexcept -> void* {  // NOLINT
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+namespace {
+constexpr std::size_t warmup_iterations{ 100 };
+constexpr std::size_t iterations{ 100'000 };
+
+struct result {
+  std::size_t allocations{};
+  std::chrono::nanoseconds per_op{};
+};
+
+auto measure(auto&& operation) -> result {
+  for (std::size_t idx = 0; idx < warmup_iterations; idx++) {
+    operation(idx);
+  }
+  auto const allocations_before{ allocations.load() };
+  auto const start{ std::chrono::steady_clock::now() };
+  for (std::size_t idx = 0; idx < iterations; idx++) {
+    operation(idx);
+  }
+  auto const elapsed{ std::chrono::steady_clock::now() - start };
+  return { .allocations = allocations.load() - allocations_before,
+           .per_op = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed) / iterations };
+}
+
+template <typename type_desc>
+auto serialize_case(std::string_view name, typename type_desc::value_t const& value) {
+  using packet_t = tfc::ipc::details::packet<typename type_desc::value_t, type_desc::value_e>;
+  typename packet_t::header_buffer_t header_buffer{};
+  std::size_t bytes{};
+  auto const res{ measure([&](std::size_t) {
+    auto const buffers{ packet_t::serialize(value, header_buffer) };
+    bytes += buffers[0].size() + buffers[1].size();
+  }) };
+  fmt::print("serialize {:<8} {:>6} ns/op {:>6} allocations ({} bytes)\n", name, res.per_op.count(), res.allocations,
+             bytes);
+  ut::expect(res.allocations == 0) << name;
+}
+
+template <typename type_desc>
+auto deserialize_case(std::string_view name, typename type_desc::value_t const& value) {
+  using packet_t = tfc::ipc::details::packet<typename type_desc::value_t, type_desc::value_e>;
+  typename packet_t::header_buffer_t header_buffer{};
+  auto const buffers{ packet_t::serialize(value, header_buffer) };
+  typename type_desc::value_t destination{};
+  std::size_t failures{};
+  auto const res{ measure([&](std::size_t) {
+    if (packet_t::deserialize_into(destination, buffers[0], buffers[1])) {
+      failures++;
+    }
+  }) };
+  fmt::print("receive   {:<8} {:>6} ns/op {:>6} allocations\n", name, res.per_op.count(), res.allocations);
+  ut::expect(failures == 0) << name;
+  ut::expect(res.allocations == 0) << name;
+}
+
+/// \param allocation_free false for payloads larger than a zmq message stores inline, zmq_msg_init_size mallocs their
+/// copy and zmq_msg_init_data mallocs the reference counted content of a zero copy message, so neither is free of
+/// allocations. The count is printed for them without being asserted.
+template <typename type_desc>
+auto send_case(asio::io_context& ctx,
+               std::string_view name,
+               typename type_desc::value_t const& value,
+               bool allocation_free = true) {
+  auto signal{ tfc::ipc::details::signal<type_desc>::create(ctx, fmt::format("serialize_benchmark_{}", name)).value() };
+  std::size_t failures{};
+  auto const res{ measure([&](std::size_t) {
+    if (signal->send(value)) {
+      failures++;
+    }
+  }) };
+  fmt::print("send      {:<8} {:>6} ns/op {:>6} allocations\n", name, res.per_op.count(), res.allocations);
+  ut::expect(failures == 0) << name;
+  if (counts_malloc && allocation_free) {
+    ut::expect(res.allocations == 0) << name;
+  }
+}
+}  // namespace
+
+auto main(int argc, char** argv) -> int {
+  tfc::base::init(argc, argv);
+  using ut::operator""_test;
+  using namespace tfc::ipc::details;
+
+  std::string const string_value(256, 'a');
+  std::string const json_value{ R"({"i":287,"d":3.14,"hello":"Hello World","arr":[1,2,3]})" };
+
+  "steady state serialization does not allocate"_test = [&] {
+    serialize_case<type_bool>("bool", true);
+    serialize_case<type_int>("int", -1337);
+    serialize_case<type_uint>("uint", 1337);
+    serialize_case<type_double>("double", 4.21337);
+    serialize_case<type_string>("string", string_value);
+    serialize_case<type_json>("json", json_value);
+  };
+
+  "steady state deserialization into a reused value does not allocate"_test = [&] {
+    deserialize_case<type_bool>("bool", true);
+    deserialize_case<type_int>("int", -1337);
+    deserialize_case<type_uint>("uint", 1337);
+    deserialize_case<type_double>("double", 4.21337);
+    deserialize_case<type_string>("string", string_value);
+    deserialize_case<type_json>("json", json_value);
+  };
+
+  // Synchronous sends of values which fit inline in a zmq message, header and payload are copied into the message
+  // itself without an allocation. async_send allocates its operation within azmq and is not covered.
+  "steady state send does not allocate"_test = [&] {
+    asio::io_context ctx{};
+    send_case<type_bool>(ctx, "bool", true);
+    send_case<type_int>(ctx, "int", -1337);
+    send_case<type_uint>(ctx, "uint", 1337);
+    send_case<type_double>(ctx, "double", 4.21337);
+    send_case<type_string>(ctx, "string", string_value, false);
+    send_case<type_json>(ctx, "json", json_value, false);
+  };
+
+  return 0;
+}
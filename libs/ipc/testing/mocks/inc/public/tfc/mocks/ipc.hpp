@@ -7,6 +7,7 @@
 #include <gmock/gmock.h>
 #include <boost/asio/io_context.hpp>
 
+#include <tfc/ipc/details/impl.hpp>
 #include <tfc/stx/concepts.hpp>
 
 namespace tfc::ipc {
@@ -17,7 +18,11 @@ template <typename type_desc, typename manager_client_type>
 struct mock_signal {
   using value_t = typename type_desc::value_t;
 
-  mock_signal(asio::io_context const&, manager_client_type&, std::string_view, std::string_view = "") {}
+  mock_signal(asio::io_context const&,
+              manager_client_type&,
+              std::string_view,
+              std::string_view = "",
+              details::transport_e = details::transport_e::zmq) {}
 
   // todo can this be done differently?
   template <typename completion_token_t>
@@ -46,7 +51,8 @@ struct mock_slot {
             manager_client_type&,
             std::string_view,
             std::string_view,
-            tfc::stx::invocable<value_t> auto&&) {
+            tfc::stx::invocable<value_t> auto&&,
+            details::receive_policy_e = details::receive_policy_e::all) {
     ON_CALL(*this, value()).WillByDefault(testing::ReturnRef(std::nullopt));
   }
   mock_slot(asio::io_context const&, manager_client_type&, std::string_view, tfc::stx::invocable<value_t> auto&&) {}
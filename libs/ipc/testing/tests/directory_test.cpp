@@ -0,0 +1,115 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/ut.hpp>
+
+#include <tfc/ipc/details/directory.hpp>
+
+auto main(int, char**) -> int {
+  namespace ut = boost::ut;
+
+  using ut::operator""_test;
+  using ut::expect;
+
+  using tfc::ipc::details::type_e;
+  using tfc::ipc_ruler::directory;
+  using tfc::ipc_ruler::signal;
+  using tfc::ipc_ruler::slot;
+
+  auto const make_signal{ [](std::string name) {
+    signal entry{};
+    entry.name = std::move(name);
+    entry.type = type_e::_bool;
+    return entry;
+  } };
+  auto const make_slot{ [](std::string name) {
+    slot entry{};
+    entry.name = std::move(name);
+    entry.type = type_e::_bool;
+    return entry;
+  } };
+
+  struct recorder {
+    std::vector<std::string> added{};
+    std::vector<std::string> removed{};
+  };
+  auto const record{ [](directory& dir, recorder& signals) {
+    dir.on_signal_added([&signals](signal const& entry) { signals.added.emplace_back(entry.name); });
+    dir.on_signal_removed([&signals](signal const& entry) { signals.removed.emplace_back(entry.name); });
+  } };
+
+  "changes are not applied before the directory is assigned"_test = [&] {
+    directory dir{};
+    expect(!dir.synchronized());
+    expect(!dir.apply_signal(1, make_signal("a")));
+    expect(dir.signals().empty());
+  };
+
+  "assign reports every signal added"_test = [&] {
+    directory dir{};
+    recorder signals{};
+    record(dir, signals);
+    dir.assign(7, { make_signal("a"), make_signal("b") }, { make_slot("x") });
+    expect(dir.synchronized());
+    expect(dir.generation() == 7);
+    expect(signals.added == std::vector<std::string>{ "a", "b" });
+    expect(dir.find_signal("a") != nullptr);
+    expect(dir.find_signal("c") == nullptr);
+    expect(dir.find_slot("x") != nullptr);
+  };
+
+  "changes apply in order of generation"_test = [&] {
+    directory dir{};
+    recorder signals{};
+    record(dir, signals);
+    dir.assign(3, {}, { make_slot("x") });
+    expect(dir.apply_signal(4, make_signal("a")));
+    expect(dir.apply_connection(5, "x", "a"));
+    expect(dir.generation() == 5);
+    expect(dir.find_slot("x")->connected_to == "a");
+    expect(dir.apply_connection(6, "x", ""));
+    expect(dir.find_slot("x")->connected_to.empty());
+    expect(signals.added == std::vector<std::string>{ "a" });
+  };
+
+  "updating a known signal does not report it added"_test = [&] {
+    directory dir{};
+    recorder signals{};
+    record(dir, signals);
+    dir.assign(0, { make_signal("a") }, {});
+    auto changed{ make_signal("a") };
+    changed.description = "changed";
+    expect(dir.apply_signal(1, changed));
+    expect(dir.find_signal("a")->description == "changed");
+    expect(signals.added.size() == 1);
+  };
+
+  "a missed change is reported and nothing is applied"_test = [&] {
+    directory dir{};
+    dir.assign(3, {}, {});
+    expect(!dir.apply_signal(5, make_signal("a")));
+    expect(!dir.apply_slot(3, make_slot("x")));
+    expect(dir.generation() == 3);
+    expect(dir.signals().empty());
+    expect(dir.slots().empty());
+  };
+
+  "assigning again reports the difference"_test = [&] {
+    directory dir{};
+    recorder signals{};
+    record(dir, signals);
+    std::vector<std::string> slots_removed{};
+    dir.on_slot_removed([&slots_removed](slot const& entry) { slots_removed.emplace_back(entry.name); });
+    dir.assign(2, { make_signal("a"), make_signal("b") }, { make_slot("x") });
+    signals.added.clear();
+    dir.assign(1, { make_signal("b"), make_signal("c") }, {});
+    expect(dir.generation() == 1);
+    expect(signals.added == std::vector<std::string>{ "c" });
+    expect(signals.removed == std::vector<std::string>{ "a" });
+    expect(slots_removed == std::vector<std::string>{ "x" });
+    expect(dir.find_signal("a") == nullptr);
+  };
+
+  return 0;
+}
@@ -1,8 +1,12 @@
 #include <chrono>
+#include <limits>
+#include <optional>
 #include <string>
+#include <tuple>
 
 #include <tfc/ipc.hpp>
 #include <tfc/ipc/details/filter.hpp>
+#include <tfc/ipc/item.hpp>
 #include <tfc/stubs/confman.hpp>
 #include <tfc/testing/asio_clock.hpp>
 
@@ -223,5 +227,196 @@ auto main(int, char**) -> int {
     ctx.run_one_for(std::chrono::seconds{ 1 });
   };
 
+  "filter median"_test = []() {
+    filter<filter_e::median, std::int64_t> median_test{};
+    median_test.median = { .window_size = 3, .send_every = 2, .send_first_at = 1 };
+    expect(median_test.process(5) == 5);
+    expect(!median_test.process(1).has_value());  // waits for send_every
+    expect(median_test.process(3) == 3);
+    expect(!median_test.process(100).has_value());
+    expect(median_test.process(2) == 3);  // window is 3, 100, 2
+    median_test.median.send_every = 1;    // reconfiguring starts over
+    expect(median_test.process(8) == 8);
+    expect(median_test.process(2) == 5);  // even number of values averages the middle two
+  };
+
+  "filter quantile"_test = []() {
+    filter<filter_e::quantile, std::double_t> quantile_test{};
+    quantile_test.quantile = { .window_size = 10, .send_every = 10, .send_first_at = 10, .quantile = 0.9 };
+    for (std::int64_t value{ 10 }; value > 1; value--) {
+      expect(!quantile_test.process(static_cast<std::double_t>(value)).has_value());
+    }
+    expect(quantile_test.process(1.0) == 9.0);
+    expect(!quantile_test.process(std::numeric_limits<std::double_t>::quiet_NaN()).has_value());
+  };
+
+  "filter sliding window moving average"_test = []() {
+    filter<filter_e::sliding_window_moving_average, std::uint64_t> average_test{};
+    average_test.sliding_window_moving_average = { .window_size = 4, .send_every = 1, .send_first_at = 1 };
+    expect(average_test.process(4) == 4);
+    expect(average_test.process(8) == 6);
+    for (std::uint64_t idx{ 0 }; idx < 20; idx++) {
+      std::ignore = average_test.process(10);
+    }
+    expect(average_test.process(14) == 11);  // window is 10, 10, 10, 14
+  };
+
+  "filter exponential moving average"_test = []() {
+    filter<filter_e::exponential_moving_average, std::double_t> average_test{};
+    average_test.exponential_moving_average = { .alpha = 0.5, .send_every = 2, .send_first_at = 1 };
+    expect(average_test.process(8.0) == 8.0);
+    expect(!average_test.process(4.0).has_value());  // mean is 6 but waits for send_every
+    expect(average_test.process(2.0) == 4.0);
+  };
+
+  "filter throttle"_test = []() {
+    filter<filter_e::throttle, std::int64_t, tfc::testing::clock> throttle_test{};
+    throttle_test.throttle = std::chrono::milliseconds{ 100 };
+    expect(throttle_test.process(1) == 1);
+    tfc::testing::clock::set_ticks(tfc::testing::clock::now() + std::chrono::milliseconds{ 99 });
+    expect(!throttle_test.process(2).has_value());
+    tfc::testing::clock::set_ticks(tfc::testing::clock::now() + std::chrono::milliseconds{ 1 });
+    expect(throttle_test.process(3) == 3);
+  };
+
+  "filter throttle average"_test = []() {
+    asio::io_context ctx{};
+    filter<filter_e::throttle_average, std::int64_t, tfc::testing::clock> average_test{};
+    average_test.throttle_average = std::chrono::milliseconds{ 10 };
+    std::optional<std::expected<std::int64_t, std::error_code>> period_mean{};
+    std::size_t dropped{ 0 };
+    average_test.async_process(2, asio::bind_executor(ctx.get_executor(), [&period_mean](auto&& return_value) {
+                                 period_mean = return_value;
+                               }));
+    for (std::int64_t value : { 4, 6 }) {
+      average_test.async_process(std::move(value), asio::bind_executor(ctx.get_executor(), [&dropped](auto&& return_value) {
+                                   expect(!return_value.has_value());
+                                   dropped++;
+                                 }));
+    }
+    ctx.poll();
+    expect(dropped == 2);
+    expect(!period_mean.has_value());
+    tfc::testing::clock::set_ticks(tfc::testing::clock::now() + std::chrono::milliseconds{ 10 });
+    ctx.run_one_for(std::chrono::seconds{ 1 });  // timer event
+    expect(period_mean.has_value() >> fatal);
+    expect(period_mean.value() == 4);
+  };
+
+  "filter delta"_test = []() {
+    filter<filter_e::delta, std::uint64_t> delta_test{};
+    delta_test.delta = 5;
+    expect(delta_test.process(10) == 10);
+    expect(!delta_test.process(14).has_value());
+    expect(!delta_test.process(6).has_value());
+    expect(delta_test.process(5) == 5);  // compared to the last value passed on, 10
+    expect(delta_test.process(0) == 0);
+  };
+
+  "filter calibrate linear"_test = []() {
+    using tfc::ipc::filter::calibration_point;
+    filter<filter_e::calibrate_linear, std::double_t> calibrate_test{};
+    expect(calibrate_test.process(42.0) == 42.0);
+    calibrate_test.calibrate_linear = std::vector<calibration_point>{ { .raw = 0, .actual = 0 },
+                                                                      { .raw = 10, .actual = 21 },
+                                                                      { .raw = 20, .actual = 39 } };
+    expect(calibrate_test.slope() > 1.94 && calibrate_test.slope() < 1.96);
+    expect(calibrate_test.process(5.0) > 10.24 && calibrate_test.process(5.0) < 10.26);
+
+    // the line is fitted when the configuration is read, the copy refits on its own changes
+    filter<filter_e::calibrate_linear, std::int64_t> from_config{};
+    expect(!glz::read_json(from_config, R"({"calibrate_linear":[{"raw":0,"actual":1},{"raw":1,"actual":3}]})") >> fatal);
+    expect(from_config.process(10) == 21);
+    auto copy{ from_config };
+    copy.calibrate_linear = std::vector<calibration_point>{ { .raw = 0, .actual = 5 } };
+    expect(copy.process(10) == 15);
+    expect(from_config.process(10) == 21);
+  };
+
+  "filter lambda"_test = []() {
+    filter<filter_e::lambda, std::double_t> lambda_test{};
+    expect(lambda_test.process(42.0) == 42.0);
+    lambda_test.lambda = std::string{ "x < 10 ? 0 : clamp(x * 0.5 - 5, 0, 20)" };
+    expect(lambda_test.process(5.0) == 0.0);
+    expect(lambda_test.process(20.0) == 5.0);
+    expect(lambda_test.process(100.0) == 20.0);
+    lambda_test.lambda = std::string{ "x +" };
+    expect(lambda_test.process(1.0).error() == std::errc::invalid_argument);
+
+    filter<filter_e::lambda, std::uint64_t> unsigned_test{};
+    expect(!glz::read_json(unsigned_test, R"({"lambda":"x - 10"})") >> fatal);
+    expect(unsigned_test.process(15) == 5);
+    expect(unsigned_test.process(5).error() == std::errc::result_out_of_range);
+  };
+
+  "lambda expressions"_test = []() {
+    using tfc::ipc::filter::expression;
+    auto const evaluate{ [](std::string_view text, double x) { return expression::compile(text).value().evaluate(x); } };
+    expect(evaluate("x * 0.1 - 40", 500) == 10.0);
+    expect(evaluate("2 - 3 - 4", 0) == -5.0);
+    expect(evaluate("-x * 2 + 1", 4) == -7.0);
+    expect(evaluate("!(x >= 3) || x == 7", 7) == 1.0);
+    expect(evaluate("x != 3 && 1", 3) == 0.0);
+    expect(evaluate("pow(2, 10) + abs(-x) % 3", 5) == 1026.0);
+    expect(expression::compile("(1 + 2) * 3 + x")->size() == 3);  // constants are folded
+    expect(!expression::compile("min(x)").has_value());
+    expect(!expression::compile("x = 3").has_value());
+    // nesting is bounded while parsing, deep input fails instead of exhausting the stack
+    auto const nested{ [](std::size_t depth) { return std::string(depth, '(') + "x" + std::string(depth, ')'); } };
+    expect(expression::compile(nested(8)).has_value());
+    expect(expression::compile(nested(20'000)).error() == std::errc::value_too_large);
+    expect(expression::compile(std::string(20'000, '-') + "x").error() == std::errc::value_too_large);
+  };
+
+  "filter json fields"_test = []() {
+    filter<filter_e::json_fields, std::string> fields_test{};
+    fields_test.json_fields = { "b", "missing", "a" };
+    expect(fields_test.process(R"({"a":1,"b":{"c":[1,2]},"d":"e"})") == std::string{ R"({"b":{"c":[1,2]},"a":1})" });
+    expect(fields_test.process(R"({"d":"e"})") == std::string{ "{}" });  // a and b of the former value are gone
+    expect(!fields_test.process("not json").has_value());
+    expect(!fields_test.process(R"({"a":1,"d":[1,2})").has_value());
+    // skipped fields are delimited without being parsed, brackets and quotes within strings do not end them
+    expect(fields_test.process(R"( { "d" : "x,}]\"" , "a" : [ {"}":"{"} ] } )") == std::string{ R"({"a":[ {"}":"{"} ]})" });
+    fields_test.json_fields = { R"(quoted "key")" };
+    expect(fields_test.process(R"({"quoted \"key\"":1})") == std::string{ R"({"quoted \"key\"":1})" });
+  };
+
+  "filter json drop"_test = []() {
+    filter<filter_e::json_drop, std::string> drop_test{};
+    expect(!glz::read_json(drop_test, R"({"json_drop":{"field":"quality","equals":"inferior"}})") >> fatal);
+    expect(!drop_test.process(R"({"quality":"inferior","id":1})").has_value());
+    expect(drop_test.process(R"({"quality":"superior","id":2})").has_value());
+    expect(drop_test.process(R"({"id":3})").has_value());
+    // whitespace is not significant on either side
+    expect(!glz::read_json(drop_test, R"({"json_drop":{"field":"range","equals":[1, 2]}})") >> fatal);
+    expect(!drop_test.process(R"({"range": [ 1,2 ]})").has_value());
+    expect(drop_test.process(R"({"range":[1,3]})").has_value());
+  };
+
+  "filter tfc item"_test = []() {
+    filter<filter_e::tfc_item, std::string> item_test{};
+    auto const item{ tfc::ipc::item::make() };
+    expect(item_test.process(item.to_json()).has_value());
+    expect(!item_test.process(R"({"item_weight":"heavy"})").has_value());
+    item_test.tfc_item.required = { "item_id", "barcode" };
+    expect(!item_test.process(item.to_json()).has_value());
+    auto with_barcode{ item };
+    with_barcode.barcode = "1234";
+    expect(item_test.process(with_barcode.to_json()).has_value());
+  };
+
+  "synchronous filters process inline"_test = []() {
+    using tfc::ipc::filter::detail::synchronous_filter;
+    static_assert(synchronous_filter<filter<filter_e::offset, std::int64_t>, std::int64_t>);
+    static_assert(synchronous_filter<filter<filter_e::filter_out, std::string>, std::string>);
+    static_assert(synchronous_filter<filter<filter_e::median, std::double_t>, std::double_t>);
+    static_assert(!synchronous_filter<filter<filter_e::timer, bool, tfc::testing::clock>, bool>);
+    filter<filter_e::multiply, std::int64_t> const multiply_test{ .multiply = 3 };
+    expect(multiply_test.process(14) == 42);
+    filter<filter_e::filter_out, std::int64_t> const filter_out_test{ .filter_out = 42 };
+    expect(!filter_out_test.process(42).has_value());
+    expect(filter_out_test.process(41) == 41);
+  };
+
   return 0;
 }
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <boost/ut.hpp>
+
+#include <tfc/ipc/details/history.hpp>
+
+auto main(int, char**) -> int {
+  namespace ut = boost::ut;
+
+  using ut::operator""_test;
+  using ut::expect;
+
+  using history_t = tfc::ipc::details::value_history<std::int64_t>;
+  using std::chrono::seconds;
+  auto const at{ [](std::int64_t second) { return history_t::time_point{ seconds{ second } }; } };
+
+  "empty history"_test = [&] {
+    history_t const history{ 4 };
+    expect(history.size() == 0);
+    expect(history.history(at(0), at(100)).values.empty());
+  };
+
+  "zero capacity records nothing"_test = [&] {
+    history_t history{};
+    history.record(at(1), 1);
+    expect(history.size() == 0);
+    expect(history.history(at(0), at(100)).values.empty());
+  };
+
+  "oldest values are overwritten once full"_test = [&] {
+    history_t history{ 3 };
+    for (std::int64_t idx{ 0 }; idx < 5; idx++) {
+      history.record(at(idx), idx * 10);
+    }
+    expect(history.size() == 3);
+    auto const samples{ history.history(at(0), at(100)) };
+    expect(samples.values == std::vector<std::int64_t>{ 20, 30, 40 });
+    expect(samples.timestamps == std::vector{ at(2), at(3), at(4) });
+  };
+
+  "range is inclusive"_test = [&] {
+    history_t history{ 8 };
+    for (std::int64_t idx{ 0 }; idx < 8; idx++) {
+      history.record(at(idx), idx);
+    }
+    expect(history.history(at(2), at(4)).values == std::vector<std::int64_t>{ 2, 3, 4 });
+    expect(history.history(at(7), at(100)).values == std::vector<std::int64_t>{ 7 });
+    expect(history.history(at(8), at(100)).values.empty());
+    expect(history.history(at(4), at(2)).values.empty());
+  };
+
+  "range within a wrapped ring"_test = [&] {
+    history_t history{ 4 };
+    for (std::int64_t idx{ 0 }; idx < 6; idx++) {
+      history.record(at(idx), idx);
+    }
+    // ring holds 2, 3, 4, 5 with 4 and 5 at the start of the storage
+    expect(history.history(at(3), at(4)).values == std::vector<std::int64_t>{ 3, 4 });
+    // bounds past every value end the search at the end of the ring
+    expect(history.history(at(4), at(100)).values == std::vector<std::int64_t>{ 4, 5 });
+    expect(history.history(at(6), at(100)).values.empty());
+  };
+
+  "downsampling keeps the extremes of each bucket in time order"_test = [&] {
+    history_t history{ 100 };
+    for (std::int64_t idx{ 0 }; idx < 100; idx++) {
+      history.record(at(idx), idx == 13 ? 1000 : idx == 71 ? -1000 : 0);
+    }
+    auto const samples{ history.history(at(0), at(100), 4) };
+    expect(samples.values.size() <= 4);
+    expect(samples.values == std::vector<std::int64_t>{ 0, 1000, 0, -1000 });
+    expect(samples.timestamps == std::vector{ at(0), at(13), at(50), at(71) });
+  };
+
+  "downsampling within max points returns every value"_test = [&] {
+    history_t history{ 10 };
+    for (std::int64_t idx{ 0 }; idx < 10; idx++) {
+      history.record(at(idx), idx);
+    }
+    expect(history.history(at(0), at(100), 10).values.size() == 10);
+    expect(history.history(at(0), at(100), 0).values.size() == 10);
+  };
+
+  "downsampling other types keeps the latest of each bucket"_test = [&] {
+    tfc::ipc::details::value_history<std::string> history{ 6 };
+    for (std::int64_t idx{ 0 }; idx < 6; idx++) {
+      history.record(at(idx), std::to_string(idx));
+    }
+    expect(history.history(at(0), at(100), 3).values == std::vector<std::string>{ "1", "3", "5" });
+  };
+
+  "one point keeps the latest value of the range"_test = [&] {
+    history_t history{ 10 };
+    for (std::int64_t idx{ 0 }; idx < 10; idx++) {
+      history.record(at(idx), idx % 2 == 0 ? 100 : -100);
+    }
+    auto const samples{ history.history(at(0), at(100), 1) };
+    expect(samples.values == std::vector<std::int64_t>{ -100 });
+    expect(samples.timestamps == std::vector{ at(9) });
+  };
+
+  "bool history"_test = [&] {
+    tfc::ipc::details::value_history<bool> history{ 4 };
+    for (std::int64_t idx{ 0 }; idx < 6; idx++) {
+      history.record(at(idx), idx % 3 == 0);
+    }
+    expect(history.history(at(0), at(100)).values == std::vector<bool>{ false, true, false, false });
+    expect(history.history(at(0), at(100), 2).values == std::vector<bool>{ true, false });
+  };
+
+  return 0;
+}
@@ -1,7 +1,11 @@
 #include <boost/asio.hpp>
 #include <boost/ut.hpp>
+#include <fmt/format.h>
+#include <sdbusplus/bus/match.hpp>
+#include <sdbusplus/message.hpp>
 
 #include <tfc/confman/file_storage.hpp>
+#include <tfc/dbus/match_rules.hpp>
 #include <tfc/ipc.hpp>
 #include <tfc/ipc/details/dbus_client_iface.hpp>
 #include <tfc/ipc/details/dbus_client_iface_mock.hpp>
@@ -31,8 +35,12 @@ struct file_storage_mock {
 
   auto make_change() { return change{ *this }; }
 
+  void on_change(std::function<void()> callback) { on_change_cb = std::move(callback); }
+
   storage_t storage_{};
   std::function<void(void)> set_changed_cb = []() {};
+  // Stands in for an edit of the file on disk
+  std::function<void(void)> on_change_cb = []() {};
 };
 
 using signal_storage_t = file_storage_mock<std::unordered_map<std::string, tfc::ipc_ruler::signal>>;
@@ -79,6 +87,79 @@ auto main(int argc, char** argv) -> int {
     ut::expect(ipc_manager->get_all_signals().empty());
   };
 
+  "register many writes each storage once"_test = []() {
+    signal_storage_t signals{};
+    slot_storage_t slots{};
+    int signal_writes{};
+    int slot_writes{};
+    signals.set_changed_cb = [&signal_writes] { signal_writes++; };
+    slots.set_changed_cb = [&slot_writes] { slot_writes++; };
+    manager_t ipc_manager{ signals, slots };
+    std::vector<std::string> connected{};
+    ipc_manager.set_callback([&connected](std::string_view slot_name, std::string_view) {
+      connected.emplace_back(slot_name);
+    });
+    auto const type{ static_cast<std::uint8_t>(tfc::ipc::details::type_e::_bool) };
+    std::vector<tfc::ipc_ruler::registration_t> const new_signals{ { "a", "first", type },
+                                                                   { "b", "", type },
+                                                                   { "c", "", type } };
+    std::vector<tfc::ipc_ruler::registration_t> const new_slots{ { "x", "", type }, { "y", "", type } };
+    auto const [registered_signals, registered_slots]{ ipc_manager.register_many(new_signals, new_slots) };
+
+    ut::expect(signal_writes == 1);
+    ut::expect(slot_writes == 1);
+    ut::expect(registered_signals.size() == 3);
+    ut::expect(registered_slots.size() == 2);
+    ut::expect(ipc_manager.get_all_signals().size() == 3);
+    ut::expect(ipc_manager.get_all_slots().size() == 2);
+    ut::expect(signals.storage_.at("a").description == "first");
+    ut::expect(connected == std::vector<std::string>{ "x", "y" });
+
+    // registering again only updates the entries
+    ipc_manager.register_many(new_signals, {});
+    ut::expect(signal_writes == 2);
+    ut::expect(slot_writes == 1);
+    ut::expect(ipc_manager.get_all_signals().size() == 3);
+  };
+
+  "connection index follows connect and disconnect"_test = []() {
+    signal_storage_t signals{};
+    slot_storage_t slots{};
+    manager_t ipc_manager{ signals, slots };
+    ipc_manager.set_callback([](std::string_view, std::string_view) {});
+    using tfc::ipc::details::type_e;
+    ipc_manager.register_signal("a", "", type_e::_bool);
+    ipc_manager.register_signal("b", "", type_e::_bool);
+    ipc_manager.register_signal("c", "", type_e::_int64_t);
+    ipc_manager.register_slot("x", "", type_e::_bool);
+    ipc_manager.register_slot("y", "", type_e::_bool);
+    auto const& index{ ipc_manager.index() };
+    ut::expect(index.signals_of_type(type_e::_bool).size() == 2);
+    ut::expect(index.signals_of_type(type_e::_int64_t).size() == 1);
+    ut::expect(index.slots_of_type(type_e::_bool).size() == 2);
+
+    ipc_manager.connect("x", "a");
+    ipc_manager.connect("y", "a");
+    ut::expect(index.slots_of("a").size() == 2);
+    ut::expect(slots.storage_.at("x").connected_to == "a");
+
+    ipc_manager.connect("x", "b");
+    ut::expect(index.slots_of("a").size() == 1);
+    ut::expect(index.slots_of("b").size() == 1);
+    ut::expect(index.connected_to("x") == "b");
+
+    ipc_manager.disconnect("y");
+    ut::expect(index.slots_of("a").empty());
+    ut::expect(slots.storage_.at("y").connected_to.empty());
+    auto const connections{ ipc_manager.get_all_connections() };
+    ut::expect(connections.size() == 3);
+    ut::expect(connections.at("b") == std::vector<std::string>{ "x" });
+
+    ut::expect(ut::throws([&] { ipc_manager.connect("x", "c"); }));  // types differ
+    ut::expect(ut::throws([&] { ipc_manager.connect("x", "d"); }));  // no such signal
+    ut::expect(index.connected_to("x") == "b");
+  };
+
   "get signals empty"_test = [] {
     test_instance instance{};
     // Check if the correct empty list is reported for signals
@@ -165,6 +246,79 @@ auto main(int argc, char** argv) -> int {
     instance.ctx.run_for(std::chrono::milliseconds(5));
     ut::expect(instance.ran);
   };
+  "registrations and connections are emitted as deltas with consecutive generations"_test = []() {
+    test_instance instance{};
+    namespace consts = tfc::ipc_ruler::consts;
+    static constexpr auto rule{ tfc::dbus::match::rules::make_match_rule<
+        consts::ipc_ruler_service_name, consts::ipc_ruler_interface_name, consts::ipc_ruler_object_path,
+        tfc::dbus::match::rules::type::signal>() };
+    std::vector<std::uint64_t> generations{};
+    std::vector<std::string> entries{};
+    auto const delta{ [&](std::string_view member, auto on_message) {
+      return sdbusplus::bus::match::match{ *instance.ipc_manager_client.connection(),
+                                           fmt::format("{}member='{}'", rule, member), on_message };
+    } };
+    auto const entry{ [&](sdbusplus::message_t& msg) {
+      auto [generation, json]{ msg.unpack<std::tuple<std::uint64_t, std::string>>() };
+      generations.emplace_back(generation);
+      entries.emplace_back(std::move(json));
+    } };
+    auto signal_added{ delta(consts::signal_added, entry) };
+    auto slot_added{ delta(consts::slot_added, entry) };
+    auto connection_changed{ delta(consts::connection_changed, [&](sdbusplus::message_t& msg) {
+      auto [generation, slot_name, signal_name]{ msg.unpack<std::tuple<std::uint64_t, std::string, std::string>>() };
+      generations.emplace_back(generation);
+      entries.emplace_back(fmt::format("{}->{}", slot_name, signal_name));
+    }) };
+
+    instance.ipc_manager_client.register_signal("test_signal", "", tfc::ipc::details::type_e::_string, [](const auto&) {});
+    instance.ctx.run_for(std::chrono::milliseconds(5));
+    instance.ipc_manager_client.register_slot("test_slot", "", tfc::ipc::details::type_e::_string, [](const auto&) {});
+    instance.ctx.run_for(std::chrono::milliseconds(5));
+    instance.ipc_manager_client.connect("test_slot", "test_signal", [](const std::error_code& err) { ut::expect(!err); });
+    instance.ctx.run_for(std::chrono::milliseconds(5));
+
+    ut::expect(generations == std::vector<std::uint64_t>{ 1, 2, 3 });
+    ut::expect(entries.size() == 3);
+    if (entries.size() == 3) {
+      ut::expect(entries[0].contains(R"("name":"test_signal")")) << entries[0];
+      ut::expect(entries[1].contains(R"("name":"test_slot")")) << entries[1];
+      ut::expect(entries[2] == "test_slot->test_signal") << entries[2];
+    }
+  };
+
+  "an edit of the files bumps the generation and tells clients to read the lists again"_test = []() {
+    test_instance instance{};
+    namespace consts = tfc::ipc_ruler::consts;
+    static constexpr auto rule{ tfc::dbus::match::rules::make_match_rule<
+        consts::ipc_ruler_service_name, consts::ipc_ruler_interface_name, consts::ipc_ruler_object_path,
+        tfc::dbus::match::rules::type::signal>() };
+    std::vector<std::uint64_t> generations{};
+    sdbusplus::bus::match::match signal_added{ *instance.ipc_manager_client.connection(),
+                                               fmt::format("{}member='{}'", rule, consts::signal_added),
+                                               [&](sdbusplus::message_t& msg) {
+                                                 auto [generation, json]{
+                                                   msg.unpack<std::tuple<std::uint64_t, std::string>>()
+                                                 };
+                                                 generations.emplace_back(generation);
+                                               } };
+    sdbusplus::bus::match::match directory_reset{ *instance.ipc_manager_client.connection(),
+                                                  fmt::format("{}member='{}'", rule, consts::directory_reset),
+                                                  [&](sdbusplus::message_t& msg) {
+                                                    auto [generation]{ msg.unpack<std::tuple<std::uint64_t>>() };
+                                                    generations.emplace_back(generation);
+                                                  } };
+
+    instance.ipc_manager_client.register_signal("test_signal", "", tfc::ipc::details::type_e::_string, [](const auto&) {});
+    instance.ctx.run_for(std::chrono::milliseconds(5));
+    instance.signals.on_change_cb();
+    instance.ctx.run_for(std::chrono::milliseconds(5));
+    instance.slots.on_change_cb();
+    instance.ctx.run_for(std::chrono::milliseconds(5));
+
+    ut::expect(generations == std::vector<std::uint64_t>{ 1, 2, 3 });
+  };
+
   "Check that re-registering a communication channel only changes last_registered "_test = []() {
     test_instance instance{};
 
@@ -1,5 +1,8 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <string>
+#include <thread>
 
 #include <tfc/ipc.hpp>
 #include <tfc/ipc/packet.hpp>
@@ -81,6 +84,27 @@ auto main(int argc, char** argv) -> int {
     };
   };
 
+  // Runs before the other tests make slots, the slots of this process are then counted from 1 and the snapshot topic
+  // of the first slot would be a prefix of those of slots 10 and 11 were it not terminated
+  "snapshots reach only the joining slot of many in one process"_test = []() {
+    asio::io_context ctx;
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(ctx, "snapshot_many").value() };
+    expect(!sender->send(7) >> fatal);
+    constexpr std::size_t slot_count{ 12 };
+    std::array<std::vector<std::int64_t>, slot_count> received{};
+    std::vector<tfc::ipc::details::int_slot_cb_ptr> slots{};
+    for (std::size_t idx = 0; idx < slot_count; idx++) {
+      slots.emplace_back(tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+          ctx, fmt::format("snapshot_many_{}", idx),
+          [&received, idx](std::int64_t value) { received[idx].emplace_back(value); }));
+      expect(!slots.back()->connect(sender->name_w_type()) >> fatal);
+      ctx.run_for(std::chrono::milliseconds(20));
+    }
+    for (auto const& values : received) {
+      expect(values == std::vector<std::int64_t>{ 7 });
+    }
+  };
+
   "ipc stop receiver"_test = [] {
     asio::io_context ctx;
     auto sender = tfc::ipc::details::uint_signal_ptr::element_type::create(ctx, "name").value();
@@ -145,5 +169,273 @@ auto main(int argc, char** argv) -> int {
     ctx.run();
   };
 
+  "message larger than any fixed receive buffer"_test = []() {
+    asio::io_context ctx;
+    std::string const large_value(64 * 1024, 'x');
+    auto sender{ tfc::ipc::details::string_signal_ptr::element_type::create(ctx, "large_name").value() };
+    std::size_t received_size{};
+    auto receiver{ tfc::ipc::details::string_slot_cb_ptr::element_type::create(
+        ctx, "large_unused", [&ctx, &received_size](std::string const& value) {
+          received_size = value.size();
+          ctx.stop();
+        }) };
+    receiver->connect(sender->name_w_type());
+    asio::steady_timer timer{ ctx };
+    timer.expires_after(std::chrono::milliseconds(1));
+    timer.async_wait([&sender, &large_value](auto) { sender->send(large_value); });
+    ctx.run_for(std::chrono::seconds(1));
+    expect(received_size == large_value.size());
+  };
+
+  "shared memory transport"_test = []() {
+    asio::io_context ctx;
+    using tfc::ipc::details::receive_policy_e;
+    using tfc::ipc::details::transport_e;
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(ctx, "shm_name", transport_e::shm).value() };
+    std::vector<std::int64_t> received{};
+    auto receiver{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+        ctx, "shm_unused",
+        [&ctx, &received](std::int64_t value) {
+          received.emplace_back(value);
+          if (value == 42) {
+            ctx.stop();
+          }
+        },
+        receive_policy_e::latest) };
+    expect(!receiver->connect(sender->name_w_type()) >> fatal);
+    // a slot receiving every value stays on zmq
+    auto every_value{ tfc::ipc::details::int_slot_ptr::element_type::create(ctx, "shm_every") };
+    expect(!every_value->connect(sender->name_w_type()) >> fatal);
+    expect(!every_value->is_shm());
+    asio::steady_timer timer{ ctx };
+    timer.expires_after(std::chrono::milliseconds(1));
+    timer.async_wait([&sender](auto) {
+      sender->send(1);
+      sender->send(42);
+    });
+    ctx.run_for(std::chrono::seconds(1));
+    // latest value semantics, the slot is guaranteed to observe the last value
+    expect(!received.empty() >> fatal);
+    expect(received.back() == 42);
+  };
+
+  "shared memory notifies a value published while the slot registers"_test = []() {
+    namespace shm = tfc::ipc::details::shm;
+    asio::io_context ctx;
+    auto publisher{ shm::publisher::create(ctx, "shm_register", shm::default_capacity).value() };
+    auto subscription{ shm::subscription::connect(ctx, "shm_register").value() };
+    bool notified{ false };
+    subscription->async_wait([&notified](std::error_code err) { notified = !err; });
+    // the publisher has not accepted the eventfd of the slot yet
+    std::array<std::byte, 3> const value{ std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+    expect(!publisher->publish(std::span<std::byte const>{ value }));
+    ctx.run_for(std::chrono::milliseconds(50));
+    expect(notified);
+    expect(subscription->has_pending());
+  };
+
+  "shared memory segment grows for a value larger than its capacity"_test = []() {
+    namespace shm = tfc::ipc::details::shm;
+    asio::io_context ctx;
+    auto publisher{ shm::publisher::create(ctx, "shm_grow", 128).value() };
+    auto subscription{ shm::subscription::connect(ctx, "shm_grow").value() };
+    std::vector<std::byte> const small(64, std::byte{ 1 });
+    expect(!publisher->publish(std::span<std::byte const>{ small }));
+    std::vector<std::byte> read{};
+    expect(!subscription->read(read));
+    expect(read == small);
+    std::vector<std::byte> const large(1000, std::byte{ 2 });
+    expect(!publisher->publish(std::span<std::byte const>{ large }));
+    expect(publisher->capacity() >= large.size());
+    expect(!subscription->read(read));
+    expect(read == large);
+  };
+
+  "latest value receive policy"_test = []() {
+    asio::io_context ctx;
+    using tfc::ipc::details::receive_policy_e;
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(ctx, "latest_name").value() };
+    std::vector<std::int64_t> received{};
+    auto receiver{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+        ctx, "latest_unused",
+        [&ctx, &received](std::int64_t value) {
+          received.emplace_back(value);
+          if (value == 42) {
+            ctx.stop();
+          }
+        },
+        receive_policy_e::latest) };
+    expect(!receiver->connect(sender->name_w_type()) >> fatal);
+    asio::steady_timer timer{ ctx };
+    timer.expires_after(std::chrono::milliseconds(1));
+    timer.async_wait([&sender](auto) {
+      // give the values time to queue up on the receiving end before the slot gets to run
+      for (std::int64_t idx{ 0 }; idx < 41; idx++) {
+        sender->send(idx);
+      }
+      sender->send(42);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    });
+    ctx.run_for(std::chrono::seconds(1));
+    expect(!received.empty() >> fatal);
+    expect(received.back() == 42);
+    expect(received.size() < 42);
+  };
+
+  "late joining slots receive the last value exactly once"_test = []() {
+    asio::io_context ctx;
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(ctx, "snapshot_name").value() };
+    expect(!sender->send(7) >> fatal);
+    std::vector<std::int64_t> first_received{};
+    std::vector<std::int64_t> second_received{};
+    auto first{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+        ctx, "snapshot_first", [&first_received](std::int64_t value) { first_received.emplace_back(value); }) };
+    auto second{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+        ctx, "snapshot_second", [&second_received](std::int64_t value) { second_received.emplace_back(value); }) };
+    expect(!first->connect(sender->name_w_type()) >> fatal);
+    ctx.run_for(std::chrono::milliseconds(50));
+    expect(!second->connect(sender->name_w_type()) >> fatal);
+    ctx.run_for(std::chrono::milliseconds(50));
+    expect(first_received == std::vector<std::int64_t>{ 7 });
+    expect(second_received == std::vector<std::int64_t>{ 7 });
+  };
+
+  "no snapshot before the signal has sent a value"_test = []() {
+    asio::io_context ctx;
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(ctx, "snapshot_unsent").value() };
+    std::vector<std::int64_t> received{};
+    auto receiver{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+        ctx, "snapshot_unsent", [&received](std::int64_t value) { received.emplace_back(value); }) };
+    expect(!receiver->connect(sender->name_w_type()) >> fatal);
+    ctx.run_for(std::chrono::milliseconds(50));
+    expect(received.empty());
+    expect(!sender->send(3) >> fatal);
+    ctx.run_for(std::chrono::milliseconds(50));
+    expect(received == std::vector<std::int64_t>{ 3 });
+  };
+
+  "batch coalesces sends until it closes"_test = []() {
+    asio::io_context ctx;
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(ctx, "batch_name").value() };
+    std::vector<std::int64_t> received{};
+    auto receiver{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+        ctx, "batch_unused", [&received](std::int64_t value) { received.emplace_back(value); }) };
+    expect(!receiver->connect(sender->name_w_type()) >> fatal);
+    ctx.run_for(std::chrono::milliseconds(50));
+    received.clear();  // the snapshot
+
+    std::vector<std::error_code> completions{};
+    {
+      tfc::ipc::batch const scope{ ctx };
+      for (std::int64_t idx{ 1 }; idx <= 3; idx++) {
+        sender->async_send(idx, [&completions](std::error_code err, std::size_t) { completions.emplace_back(err); });
+      }
+      ctx.run_for(std::chrono::milliseconds(10));
+      expect(completions.empty());  // nothing is sent before the batch closes
+    }
+    ctx.run_for(std::chrono::milliseconds(50));
+    expect(received == std::vector<std::int64_t>{ 3 });
+    // the superseded values are not published, their sends do not report success
+    auto const canceled{ std::make_error_code(std::errc::operation_canceled) };
+    expect(completions == std::vector<std::error_code>{ canceled, canceled, std::error_code{} });
+  };
+
+  "v0 headers are still accepted"_test = []() {
+    using packet_t = packet<std::string, type_e::_string>;
+    packet_t::header_buffer_t header_buffer{};
+    std::string const value{ "legacy" };
+    auto const buffers{ packet_t::serialize(value, header_buffer, { .version = tfc::ipc::details::version_e::v0 }) };
+    expect(buffers[0].size() == 10);
+    auto const result{ packet_t::deserialize(buffers[0], buffers[1]) };
+    expect(result.has_value() >> fatal);
+    expect(result.value() == value);
+  };
+
+  "crc mismatch is rejected"_test = []() {
+    using packet_t = packet<std::string, type_e::_string>;
+    packet_t::header_buffer_t header_buffer{};
+    std::string const value{ "hello" };
+    auto const buffers{ packet_t::serialize(value, header_buffer, { .flags = tfc::ipc::details::header_flags_e::crc }) };
+    expect(packet_t::deserialize(buffers[0], buffers[1]).has_value());
+    std::string const tampered{ "jello" };
+    auto const result{ packet_t::deserialize(buffers[0], std::as_bytes(std::span{ tampered })) };
+    expect(!result.has_value() >> fatal);
+    expect(result.error() == std::errc::bad_message);
+  };
+
+  "latency histogram quantiles"_test = []() {
+    tfc::ipc::details::latency_histogram histogram{};
+    expect(histogram.quantile(0.5).count() == 0);
+    for (int idx{ 0 }; idx < 99; idx++) {
+      histogram.record(std::chrono::nanoseconds{ 1000 });  // bucket [512, 1024)
+    }
+    histogram.record(std::chrono::milliseconds{ 1 });  // bucket [524288, 1048576)
+    expect(histogram.count() == 100);
+    expect(histogram.quantile(0.5).count() == 1023);
+    expect(histogram.quantile(1.0).count() == 1048575);
+  };
+
+  "slots account for received values"_test = []() {
+    asio::io_context ctx;
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(ctx, "statistics_name").value() };
+    sender->enable_crc(true);
+    auto receiver{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(ctx, "statistics_unused", [](std::int64_t) {}) };
+    expect(!receiver->connect(sender->name_w_type()) >> fatal);
+    ctx.run_for(std::chrono::milliseconds(50));
+    for (std::int64_t idx{ 1 }; idx <= 10; idx++) {
+      expect(!sender->send(idx));
+    }
+    ctx.run_for(std::chrono::milliseconds(50));
+    auto const& statistics{ receiver->statistics() };
+    expect(statistics.received == 11);  // the snapshot and ten values
+    expect(statistics.dropped == 0);
+    expect(statistics.gaps == 0);
+    expect(statistics.errors == 0);
+    expect(statistics.latency.count() == 11);
+  };
+
+  "signals publish from worker threads through their strand"_test = []() {
+    asio::io_context ctx;
+    auto work{ asio::make_work_guard(ctx) };
+    tfc::ipc::details::strand_t const signal_strand{ asio::make_strand(ctx) };
+    tfc::ipc::details::strand_t const slot_strand{ asio::make_strand(ctx) };
+    auto sender{ tfc::ipc::details::int_signal_ptr::element_type::create(signal_strand, "strand_name").value() };
+    std::vector<std::int64_t> received{};
+    std::atomic<std::int64_t> last_received{};
+    auto receiver{ tfc::ipc::details::int_slot_cb_ptr::element_type::create(
+        slot_strand, "strand_unused", [&slot_strand, &received, &last_received](std::int64_t value) {
+          expect(slot_strand.running_in_this_thread());
+          received.emplace_back(value);
+          last_received = value;
+        }) };
+    asio::post(slot_strand, [&receiver, &sender] { expect(!receiver->connect(sender->name_w_type()) >> fatal); });
+    std::vector<std::jthread> runners{};
+    for (int idx{ 0 }; idx < 2; idx++) {
+      runners.emplace_back([&ctx] { ctx.run(); });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::atomic<std::size_t> completions{};
+    std::jthread worker{ [&sender, &signal_strand, &completions] {
+      for (std::int64_t idx{ 1 }; idx <= 100; idx++) {
+        sender->async_send(idx, [&signal_strand, &completions](std::error_code err, std::size_t) {
+          expect(!err);
+          expect(signal_strand.running_in_this_thread());
+          completions++;
+        });
+      }
+    } };
+    worker.join();
+    for (int retries{ 0 }; retries < 100 && (completions < 100 || last_received != 100); retries++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    work.reset();
+    ctx.stop();
+    runners.clear();
+    expect(completions == 100);
+    expect(last_received == 100);
+    expect(std::ranges::is_sorted(received));
+  };
+
   return 0;
 }
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace tfc::stx {
+
+template <typename signature_t, std::size_t buffer_size = 6 * sizeof(void*)>
+class small_function;
+
+/**
+ * @brief
+ * Move only type erased callable, like std::move_only_function, which stores callables of up to buffer_size bytes
+ * within itself. Constructing it from a lambda capturing a few references or pointers does not allocate, and a call
+ * is one indirect call. Larger callables are stored on the heap.
+ * @example
+ * small_function<void(int&)> callback{ [this](int& value) { sum_ += value; } };
+ */
+template <typename return_t, typename... args_t, std::size_t buffer_size>
+class small_function<return_t(args_t...), buffer_size> {
+public:
+  /// \return true if callable_t is stored within the small_function, without allocating
+  template <typename callable_t>
+  static constexpr bool stored_inline_v{ sizeof(callable_t) <= buffer_size &&
+                                         alignof(callable_t) <= alignof(std::max_align_t) &&
+                                         std::is_nothrow_move_constructible_v<callable_t> };
+
+  small_function() noexcept = default;
+  small_function(std::nullptr_t) noexcept {}  // NOLINT(google-explicit-constructor) same as std::function
+
+  template <typename callable_t>
+    requires(!std::is_same_v<std::remove_cvref_t<callable_t>, small_function> &&
+             std::is_invocable_r_v<return_t, std::decay_t<callable_t>&, args_t...>)
+  small_function(callable_t&& callable) {  // NOLINT(google-explicit-constructor) same as std::function
+    using stored_t = std::decay_t<callable_t>;
+    if constexpr (std::is_pointer_v<stored_t> || std::is_member_pointer_v<stored_t>) {
+      if (callable == nullptr) {
+        return;
+      }
+    }
+    if constexpr (stored_inline_v<stored_t>) {
+      ::new (static_cast<void*>(storage_.buffer)) stored_t(std::forward<callable_t>(callable));
+    } else {
+      storage_.heap = new stored_t(std::forward<callable_t>(callable));
+    }
+    invoke_ = &invoke<stored_t>;
+    manage_ = &manage<stored_t>;
+  }
+
+  small_function(small_function&& other) noexcept { take(other); }
+  auto operator=(small_function&& other) noexcept -> small_function& {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+  auto operator=(std::nullptr_t) noexcept -> small_function& {
+    reset();
+    return *this;
+  }
+  small_function(small_function const&) = delete;
+  auto operator=(small_function const&) -> small_function& = delete;
+  ~small_function() { reset(); }
+
+  [[nodiscard]] explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+  /// \pre *this holds a callable
+  auto operator()(args_t... args) -> return_t { return invoke_(storage_, std::forward<args_t>(args)...); }
+
+private:
+  union storage {
+    alignas(std::max_align_t) std::byte buffer[buffer_size];
+    void* heap;
+  };
+
+  enum struct operation_e : std::uint8_t { move, destroy };
+
+  using invoke_t = return_t (*)(storage&, args_t&&...);
+  using manage_t = void (*)(operation_e, storage& self, storage& other) noexcept;
+
+  template <typename stored_t>
+  static auto get(storage& from) noexcept -> stored_t& {
+    if constexpr (stored_inline_v<stored_t>) {
+      return *std::launder(reinterpret_cast<stored_t*>(from.buffer));
+    } else {
+      return *static_cast<stored_t*>(from.heap);
+    }
+  }
+
+  template <typename stored_t>
+  static auto invoke(storage& self, args_t&&... args) -> return_t {
+    return std::invoke_r<return_t>(get<stored_t>(self), std::forward<args_t>(args)...);
+  }
+
+  /// \brief move other into self, or destroy self
+  template <typename stored_t>
+  static void manage(operation_e operation, storage& self, storage& other) noexcept {
+    switch (operation) {
+      case operation_e::move:
+        if constexpr (stored_inline_v<stored_t>) {
+          ::new (static_cast<void*>(self.buffer)) stored_t(std::move(get<stored_t>(other)));
+          std::destroy_at(&get<stored_t>(other));
+        } else {
+          self.heap = std::exchange(other.heap, nullptr);
+        }
+        return;
+      case operation_e::destroy:
+        if constexpr (stored_inline_v<stored_t>) {
+          std::destroy_at(&get<stored_t>(self));
+        } else {
+          delete &get<stored_t>(self);
+        }
+        return;
+    }
+  }
+
+  void take(small_function& other) noexcept {
+    if (other.manage_ != nullptr) {
+      other.manage_(operation_e::move, storage_, other.storage_);
+    }
+    invoke_ = std::exchange(other.invoke_, nullptr);
+    manage_ = std::exchange(other.manage_, nullptr);
+  }
+
+  void reset() noexcept {
+    if (manage_ != nullptr) {
+      manage_(operation_e::destroy, storage_, storage_);
+    }
+    invoke_ = nullptr;
+    manage_ = nullptr;
+  }
+
+  storage storage_;  // NOLINT(cppcoreguidelines-pro-type-member-init) only read once a callable is stored
+  invoke_t invoke_{ nullptr };
+  manage_t manage_{ nullptr };
+};
+
+}  // namespace tfc::stx
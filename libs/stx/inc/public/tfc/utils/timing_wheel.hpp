@@ -0,0 +1,336 @@
+#pragma once
+
+/// \file timing_wheel.hpp
+/// \brief Hashed timing wheel, many cheap timers multiplexed onto one asio timer per execution context
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/execution_context.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/query.hpp>
+#include <boost/asio/wait_traits.hpp>
+
+namespace tfc::utils {
+
+namespace asio = boost::asio;
+
+/**
+ * @brief
+ * Timers with a resolution of one tick, scheduled and cancelled in O(1). A single asio timer of clock_type wakes the
+ * wheel up at the next tick which has timers due, and every timer due by then is fired from that one wake up.
+ * There is one wheel per execution context, see of(). Handlers are invoked on the executor of the wheel, a handler
+ * which needs to run on a strand dispatches itself to it.
+ * Thread safety: timers may be scheduled and cancelled from any thread, handlers are invoked without the wheel locked
+ * so they may schedule and cancel timers themselves.
+ * @tparam clock_type std::chrono::steady_clock, or tfc::testing::clock in tests
+ * @tparam wait_traits_t of the asio timer, tfc::testing::wait_traits makes it see a tfc::testing::clock change on poll
+ */
+template <typename clock_type, typename wait_traits_t = asio::wait_traits<clock_type>>
+class basic_timing_wheel : public asio::execution_context::service {
+public:
+  using duration = typename clock_type::duration;
+  using time_point = typename clock_type::time_point;
+  using handler_t = std::move_only_function<void(std::error_code const&)>;
+
+  static constexpr std::chrono::milliseconds resolution{ 1 };
+  static constexpr std::size_t slot_count{ 512 };
+
+  /// \brief refers to a scheduled timer, stays safe to cancel after the timer has fired
+  struct handle {
+    std::uint32_t index{ nil };
+    std::uint32_t generation{};
+
+    [[nodiscard]] explicit operator bool() const noexcept { return index != nil; }
+  };
+
+  inline static asio::execution_context::id id{};  // NOLINT(readability-identifier-naming) asio service convention
+
+  explicit basic_timing_wheel(asio::execution_context& ctx)
+      : asio::execution_context::service{ ctx }, origin_{ clock_type::now() } {
+    slots_.fill(nil);
+  }
+
+  /// \return the wheel of the io_context, made on first use
+  /// \note the wheel runs its timer on the executor of the io_context, whoever asks for it first
+  static auto of(asio::io_context& ctx) -> basic_timing_wheel& {
+    auto& wheel{ asio::use_service<basic_timing_wheel>(ctx) };
+    std::lock_guard const lock{ wheel.mutex_ };
+    if (!wheel.timer_) {
+      wheel.timer_.emplace(ctx.get_executor());
+    }
+    return wheel;
+  }
+
+  /// \return the wheel of the execution context of the executor, made on first use
+  /// \param executor of an io_context, or a strand or any_io_executor wrapping one
+  static auto of(auto const& executor) -> basic_timing_wheel& {
+    return of(static_cast<asio::io_context&>(asio::query(executor, asio::execution::context)));
+  }
+
+  /// \brief invoke handler with no error once delay has elapsed, or with operation_aborted when cancelled
+  auto schedule_after(duration delay, handler_t handler) -> handle {
+    return schedule_at(clock_type::now() + delay, std::move(handler));
+  }
+
+  auto schedule_at(time_point deadline, handler_t handler) -> handle {
+    // Rounded up, a timer never fires before its deadline
+    auto const since_origin{ deadline - origin_ };
+    auto tick{ since_origin <= duration::zero() ? std::uint64_t{ 0 }
+                                                : static_cast<std::uint64_t>((since_origin + tick_length - duration{ 1 }) /
+                                                                             tick_length) };
+
+    std::lock_guard const lock{ mutex_ };
+    auto const idx{ allocate() };
+    auto& scheduled{ entries_[idx] };
+    scheduled.deadline_tick = tick;
+    scheduled.handler = std::move(handler);
+    pending_++;
+    if (tick <= processed_tick_) {
+      // The slot of its tick has already been processed, it is due right away
+      scheduled.state = state_e::due;
+      asio::post(timer_->get_executor(), [this, idx, generation = scheduled.generation]() { fire_due(idx, generation); });
+      return { .index = idx, .generation = scheduled.generation };
+    }
+    scheduled.state = state_e::scheduled;
+    link(idx);
+    if (!armed_ || tick < armed_tick_) {
+      arm(tick);
+    }
+    return { .index = idx, .generation = scheduled.generation };
+  }
+
+  /// \brief cancel a scheduled timer, its handler is posted with operation_aborted
+  /// \return false if the timer has already fired or been cancelled
+  auto cancel(handle& timer) -> bool {
+    auto const idx{ std::exchange(timer.index, nil) };
+    std::lock_guard const lock{ mutex_ };
+    if (idx == nil || idx >= entries_.size() || entries_[idx].generation != timer.generation) {
+      return false;
+    }
+    auto& cancelled{ entries_[idx] };
+    switch (cancelled.state) {
+      case state_e::scheduled:
+        unlink(idx);
+        post_aborted(std::move(cancelled.handler));
+        release(idx);
+        pending_--;
+        return true;
+      case state_e::due:
+        // fire() or fire_due() is about to invoke it, they skip cancelled entries and release them
+        post_aborted(std::move(cancelled.handler));
+        cancelled.state = state_e::cancelled;
+        pending_--;
+        return true;
+      case state_e::free:
+      case state_e::cancelled:
+        return false;
+    }
+    return false;
+  }
+
+  /// \return number of timers scheduled
+  [[nodiscard]] auto size() const -> std::size_t {
+    std::lock_guard const lock{ mutex_ };
+    return pending_;
+  }
+
+private:
+  static constexpr std::uint32_t nil{ std::numeric_limits<std::uint32_t>::max() };
+  static constexpr duration tick_length{ std::chrono::duration_cast<duration>(resolution) };
+  static constexpr std::uint64_t slot_mask{ slot_count - 1 };
+  static_assert(std::has_single_bit(slot_count));
+
+  enum struct state_e : std::uint8_t { free, scheduled, due, cancelled };
+
+  struct entry {
+    std::uint64_t deadline_tick{};
+    handler_t handler{};
+    std::uint32_t next{ nil };
+    std::uint32_t prev{ nil };
+    std::uint32_t generation{};
+    state_e state{ state_e::free };
+  };
+
+  void shutdown() override {
+    // asio convention, handlers are destroyed without being invoked
+    std::lock_guard const lock{ mutex_ };
+    // The timer service may have been made after the wheel, and is then destroyed before it
+    timer_.reset();
+    entries_.clear();
+    free_.clear();
+    slots_.fill(nil);
+    occupied_.fill(0);
+    pending_ = 0;
+  }
+
+  auto allocate() -> std::uint32_t {
+    if (!free_.empty()) {
+      auto const idx{ free_.back() };
+      free_.pop_back();
+      return idx;
+    }
+    entries_.emplace_back();
+    return static_cast<std::uint32_t>(entries_.size() - 1);
+  }
+
+  void release(std::uint32_t idx) {
+    auto& released{ entries_[idx] };
+    released.handler = nullptr;
+    released.state = state_e::free;
+    released.generation++;  // outstanding handles no longer match
+    free_.emplace_back(idx);
+  }
+
+  void link(std::uint32_t idx) {
+    auto const slot{ entries_[idx].deadline_tick & slot_mask };
+    auto& head{ slots_[slot] };
+    entries_[idx].prev = nil;
+    entries_[idx].next = head;
+    if (head != nil) {
+      entries_[head].prev = idx;
+    }
+    head = idx;
+    occupied_[slot / 64] |= std::uint64_t{ 1 } << (slot % 64);
+  }
+
+  void unlink(std::uint32_t idx) {
+    auto const& linked{ entries_[idx] };
+    auto const slot{ linked.deadline_tick & slot_mask };
+    if (linked.prev != nil) {
+      entries_[linked.prev].next = linked.next;
+    } else {
+      slots_[slot] = linked.next;
+    }
+    if (linked.next != nil) {
+      entries_[linked.next].prev = linked.prev;
+    }
+    if (slots_[slot] == nil) {
+      occupied_[slot / 64] &= ~(std::uint64_t{ 1 } << (slot % 64));
+    }
+  }
+
+  void post_aborted(handler_t handler) {
+    asio::post(timer_->get_executor(), [moved = std::move(handler)]() mutable {
+      moved(asio::error::make_error_code(asio::error::operation_aborted));
+    });
+  }
+
+  /// \pre mutex_ is locked
+  void arm(std::uint64_t tick) {
+    armed_ = true;
+    armed_tick_ = tick;
+    timer_->expires_at(origin_ + tick_length * static_cast<typename duration::rep>(tick));
+    timer_->async_wait([this](std::error_code const& error) {
+      if (error) {
+        return;  // re-armed or shut down
+      }
+      fire();
+    });
+  }
+
+  void fire() {
+    std::unique_lock lock{ mutex_ };
+    armed_ = false;
+    auto const since_origin{ clock_type::now() - origin_ };
+    auto const now_tick{ since_origin <= duration::zero() ? std::uint64_t{ 0 }
+                                                          : static_cast<std::uint64_t>(since_origin / tick_length) };
+    // Collect what is due before invoking anything, handlers may schedule and cancel
+    std::uint32_t due{ nil };
+    auto const ticks{ std::min<std::uint64_t>(now_tick - std::min(now_tick, processed_tick_), slot_count) };
+    for (std::uint64_t offset{ 1 }; offset <= ticks; offset++) {
+      auto idx{ slots_[(processed_tick_ + offset) & slot_mask] };
+      while (idx != nil) {
+        auto const next{ entries_[idx].next };
+        if (entries_[idx].deadline_tick <= now_tick) {
+          unlink(idx);
+          entries_[idx].state = state_e::due;
+          entries_[idx].next = due;
+          due = idx;
+        }
+        idx = next;
+      }
+    }
+    processed_tick_ = std::max(processed_tick_, now_tick);
+    while (due != nil) {
+      auto const idx{ due };
+      due = entries_[idx].next;
+      if (entries_[idx].state == state_e::cancelled) {
+        release(idx);
+        continue;
+      }
+      auto handler{ std::move(entries_[idx].handler) };
+      release(idx);
+      pending_--;
+      lock.unlock();
+      handler(std::error_code{});
+      lock.lock();
+    }
+    if (pending_ > 0) {
+      // handlers may have armed the timer for a later timer of their own
+      if (auto const next{ next_occupied_tick() }; !armed_ || next < armed_tick_) {
+        arm(next);
+      }
+    }
+  }
+
+  void fire_due(std::uint32_t idx, std::uint32_t generation) {
+    std::unique_lock lock{ mutex_ };
+    if (idx >= entries_.size() || entries_[idx].generation != generation) {
+      return;
+    }
+    if (entries_[idx].state == state_e::cancelled) {
+      release(idx);
+      return;
+    }
+    auto handler{ std::move(entries_[idx].handler) };
+    release(idx);
+    pending_--;
+    lock.unlock();
+    handler(std::error_code{});
+  }
+
+  /// \return tick of the first slot after the processed one holding timers, they may be due revolutions later
+  [[nodiscard]] auto next_occupied_tick() const noexcept -> std::uint64_t {
+    auto const start{ (processed_tick_ + 1) & slot_mask };
+    for (std::uint64_t offset{ 0 }; offset < slot_count;) {
+      auto const slot{ (start + offset) & slot_mask };
+      if (auto const bits{ occupied_[slot / 64] >> (slot % 64) }; bits != 0) {
+        return processed_tick_ + 1 + offset + static_cast<std::uint64_t>(std::countr_zero(bits));
+      }
+      offset += 64 - slot % 64;
+    }
+    return processed_tick_ + slot_count;
+  }
+
+  mutable std::mutex mutex_{};
+  std::optional<asio::basic_waitable_timer<clock_type, wait_traits_t>> timer_{};
+  time_point origin_;
+  std::uint64_t processed_tick_{ 0 };
+  std::uint64_t armed_tick_{ 0 };
+  bool armed_{ false };
+  std::size_t pending_{ 0 };
+  std::vector<entry> entries_{};
+  std::vector<std::uint32_t> free_{};
+  std::array<std::uint32_t, slot_count> slots_{};
+  std::array<std::uint64_t, slot_count / 64> occupied_{};
+};
+
+using timing_wheel = basic_timing_wheel<std::chrono::steady_clock>;
+
+}  // namespace tfc::utils
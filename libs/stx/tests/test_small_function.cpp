@@ -0,0 +1,84 @@
+#include <array>
+#include <memory>
+#include <string>
+
+#include <boost/ut.hpp>
+
+#include <tfc/stx/small_function.hpp>
+
+namespace ut = boost::ut;
+
+using tfc::stx::small_function;
+
+auto main() -> int {
+  using ut::operator""_test;
+  using ut::expect;
+
+  "lambda capturing references is stored inline"_test = [] {
+    int sum{};
+    int calls{};
+    auto callback{ [&sum, &calls](int& value) {
+      sum += value;
+      calls++;
+    } };
+    static_assert(small_function<void(int&)>::stored_inline_v<decltype(callback)>);
+    small_function<void(int&)> function{ callback };
+    int value{ 3 };
+    function(value);
+    function(value);
+    expect(sum == 6);
+    expect(calls == 2);
+  };
+
+  "empty and nullptr"_test = [] {
+    small_function<void()> empty{};
+    expect(!empty);
+    small_function<void()> null{ nullptr };
+    expect(!null);
+    void (*function_ptr)() = nullptr;
+    small_function<void()> from_null_ptr{ function_ptr };
+    expect(!from_null_ptr);
+    small_function<void()> assigned{ [] {} };
+    expect(static_cast<bool>(assigned));
+    assigned = nullptr;
+    expect(!assigned);
+  };
+
+  "move only callable"_test = [] {
+    auto owned{ std::make_unique<int>(42) };
+    small_function<int()> function{ [owned = std::move(owned)] { return *owned; } };
+    small_function<int()> moved{ std::move(function) };
+    expect(!function);  // NOLINT(bugprone-use-after-move) moved from is empty
+    expect(moved() == 42);
+  };
+
+  "large callable is stored on the heap"_test = [] {
+    std::array<int, 64> large{};
+    large.back() = 7;
+    auto callback{ [large] { return large.back(); } };
+    static_assert(!small_function<int()>::stored_inline_v<decltype(callback)>);
+    small_function<int()> function{ callback };
+    small_function<int()> moved{};
+    moved = std::move(function);
+    expect(moved() == 7);
+  };
+
+  "captures are destroyed once"_test = [] {
+    auto counter{ std::make_shared<int>() };
+    {
+      small_function<long()> function{ [counter] { return counter.use_count(); } };
+      expect(counter.use_count() == 2);
+      small_function<long()> moved{ std::move(function) };
+      expect(counter.use_count() == 2);
+      expect(moved() == 2);
+    }
+    expect(counter.use_count() == 1);
+  };
+
+  "arguments are forwarded"_test = [] {
+    small_function<std::string(std::string&&)> function{ [](std::string&& text) { return std::move(text) + "!"; } };
+    expect(function(std::string{ "hello" }) == "hello!");
+  };
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include <chrono>
+#include <functional>
+#include <system_error>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/ut.hpp>
+
+#include <tfc/testing/asio_clock.hpp>
+#include <tfc/utils/timing_wheel.hpp>
+
+namespace asio = boost::asio;
+namespace ut = boost::ut;
+
+using std::chrono_literals::operator""ms;
+using wheel_t = tfc::utils::basic_timing_wheel<tfc::testing::clock, tfc::testing::wait_traits>;
+
+namespace {
+void advance(std::chrono::milliseconds delta) {
+  tfc::testing::clock::set_ticks(tfc::testing::clock::now() + delta);
+}
+}  // namespace
+
+auto main() -> int {
+  using ut::operator""_test;
+  using ut::expect;
+
+  "one wheel per io_context"_test = [] {
+    asio::io_context ctx{};
+    asio::io_context other{};
+    expect(&wheel_t::of(ctx) == &wheel_t::of(ctx.get_executor()));
+    expect(&wheel_t::of(ctx) != &wheel_t::of(other));
+  };
+
+  "wheel first asked for through a strand runs on the io_context"_test = [] {
+    asio::io_context ctx{};
+    asio::strand<asio::io_context::executor_type> strand{ ctx.get_executor() };
+    auto& wheel{ wheel_t::of(strand) };
+    expect(&wheel == &wheel_t::of(ctx));
+    bool on_strand{ true };
+    wheel.schedule_after(0ms, [&strand, &on_strand](std::error_code const&) {
+      on_strand = strand.running_in_this_thread();
+    });
+    ctx.poll();
+    expect(!on_strand);
+  };
+
+  "timers fire in order of their deadline"_test = [] {
+    asio::io_context ctx{};
+    auto& wheel{ wheel_t::of(ctx) };
+    std::vector<int> fired{};
+    wheel.schedule_after(20ms, [&fired](std::error_code const& err) {
+      expect(!err);
+      fired.emplace_back(20);
+    });
+    wheel.schedule_after(10ms, [&fired](std::error_code const& err) {
+      expect(!err);
+      fired.emplace_back(10);
+    });
+    expect(wheel.size() == 2);
+    advance(9ms);
+    ctx.poll();
+    expect(fired.empty());
+    advance(1ms);
+    ctx.run_one_for(10ms);
+    expect(fired == std::vector{ 10 });
+    advance(10ms);
+    ctx.run_one_for(10ms);
+    expect(fired == std::vector{ 10, 20 });
+    expect(wheel.size() == 0);
+  };
+
+  "timer without delay fires without the clock moving"_test = [] {
+    asio::io_context ctx{};
+    auto& wheel{ wheel_t::of(ctx) };
+    int calls{};
+    wheel.schedule_after(0ms, [&calls](std::error_code const& err) {
+      expect(!err);
+      calls++;
+    });
+    ctx.run_one_for(10ms);
+    wheel.schedule_after(0ms, [&calls](std::error_code const&) { calls++; });
+    ctx.restart();
+    ctx.run_one_for(10ms);
+    expect(calls == 2);
+  };
+
+  "cancelled timer is called with operation_aborted"_test = [] {
+    asio::io_context ctx{};
+    auto& wheel{ wheel_t::of(ctx) };
+    std::error_code result{};
+    auto handle{ wheel.schedule_after(5ms, [&result](std::error_code const& err) { result = err; }) };
+    expect(static_cast<bool>(handle));
+    expect(wheel.cancel(handle));
+    expect(!handle);
+    expect(!wheel.cancel(handle));
+    ctx.poll();
+    expect(result == std::errc::operation_canceled);
+    expect(wheel.size() == 0);
+  };
+
+  "cancelling a fired timer is a no-op"_test = [] {
+    asio::io_context ctx{};
+    auto& wheel{ wheel_t::of(ctx) };
+    int calls{};
+    auto handle{ wheel.schedule_after(1ms, [&calls](std::error_code const&) { calls++; }) };
+    advance(1ms);
+    ctx.run_one_for(10ms);
+    // the slot of the fired timer is reused, the stale handle must not cancel the new timer
+    auto reused{ wheel.schedule_after(1ms, [&calls](std::error_code const&) { calls++; }) };
+    expect(!wheel.cancel(handle));
+    expect(wheel.size() == 1);
+    advance(1ms);
+    ctx.restart();  // ran out of work once the first timer fired
+    ctx.run_one_for(10ms);
+    expect(calls == 2);
+    expect(!wheel.cancel(reused));
+  };
+
+  "timers beyond one revolution of the wheel"_test = [] {
+    asio::io_context ctx{};
+    auto& wheel{ wheel_t::of(ctx) };
+    bool fired{ false };
+    auto const revolution{ wheel_t::slot_count * wheel_t::resolution };
+    wheel.schedule_after(revolution + 3ms, [&fired](std::error_code const&) { fired = true; });
+    advance(revolution);
+    ctx.poll();
+    expect(!fired);
+    advance(3ms);
+    ctx.poll();
+    expect(fired);
+  };
+
+  "handler may schedule the next timer"_test = [] {
+    asio::io_context ctx{};
+    auto& wheel{ wheel_t::of(ctx) };
+    int ticks{};
+    std::function<void(std::error_code const&)> periodic{};
+    periodic = [&](std::error_code const& err) {
+      if (!err && ++ticks < 3) {
+        wheel.schedule_after(2ms, periodic);
+      }
+    };
+    wheel.schedule_after(2ms, periodic);
+    for (int idx{ 0 }; idx < 3; idx++) {
+      advance(2ms);
+      ctx.poll();
+    }
+    expect(ticks == 3);
+  };
+
+  "pending handlers are destroyed without being called with the io_context"_test = [] {
+    bool called{ false };
+    {
+      asio::io_context ctx{};
+      wheel_t::of(ctx).schedule_after(1ms, [&called](std::error_code const&) { called = true; });
+    }
+    expect(!called);
+  };
+
+  return 0;
+}